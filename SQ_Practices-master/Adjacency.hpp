@@ -0,0 +1,39 @@
+/**
+ * @file Adjacency.hpp
+ * @brief header files for Adjacency struct declaration
+ *
+ */
+
+#ifndef ADJACENCY_HPP
+#define ADJACENCY_HPP
+
+#include <vector>
+
+/**
+ * @brief Restriction seen from one of its transistors
+ *
+ */
+
+struct AdjRestriction
+{
+    unsigned neighbour;	///< Transistor at the other end of the restriction
+    int bound;			///< Bound of frequency difference when a interference starts to appear
+    int interference;	///< Interference produced
+};
+
+
+/**
+ * @brief Compressed adjacency of the restriction graph
+ *
+ * The restrictions incident to transistor t, in either direction, are stored in
+ * entries[offsets[t]] .. entries[offsets[t+1]-1].
+ */
+
+struct Adjacency
+{
+    std::vector<unsigned> offsets;			///< Position of the first restriction of each transistor (size T+1)
+    std::vector<AdjRestriction> entries;	///< Incident restrictions grouped by transistor
+};
+
+
+#endif /* ADJACENCY_HPP */
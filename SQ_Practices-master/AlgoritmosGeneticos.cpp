@@ -5,11 +5,137 @@
 */
 
 #include "AlgoritmosGeneticos.hpp"
+#include "BusquedaTabu.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+
+/**
+ * @brief One generation of the generational genetic algorithm, restarting the population when it stagnates
+ *
+ * The evaluations are charged to the budget of the population by the individuals themselves.
+ * @param [in,out]  entorno		  		The individuals the algorithm will affect
+ * @param [in]      cruce 		  		Cross probability
+ * @param [in]      tipo 			  	Cross type, 0 = BLX		 1 = 2 Points
+ * @param [in]      mutacion 		  	Mutation probability
+ * @param [in,out]  generaciones 	  	Generations left without improvement before restarting
+ * @param [in,out]  guardia 		  	Best interference seen so far
+ */
+
+static void pasoGeneracional(Poblacion& entorno,double cruce,int tipo,double mutacion,
+        int& generaciones,int& guardia){
+    
+    entorno.evolucionGeneracional(cruce,tipo,mutacion);
+    
+    if(guardia != entorno.getMejorInterferencia()){
+        generaciones = 20;
+        guardia=entorno.getMejorInterferencia();
+    } else {
+        --generaciones;
+        if(!generaciones){
+            entorno.reinicializar();
+            return;
+        }
+    }
+    
+    if(entorno.comprobarRepetidos())
+        entorno.reinicializar();
+}
+
+
+/**
+ * @brief Takes the counters of a driver from the checkpoint being resumed, if there is one
+ *
+ * @param [in,out]  entorno		  		Population of the search
+ * @param [out]     estado		  		Counters of the driver, only written when resuming
+ * @return 								true if the search is resumed
+ */
+
+static bool reanudarBusqueda(Poblacion& entorno,EstadoBusqueda& estado){
+    
+    Checkpoint* checkpoint = entorno.getCheckpoint();
+    return checkpoint && checkpoint->reanudar(estado);
+}
+
+
+/**
+ * @brief Saves the search, if it has a checkpoint, at the start of an iteration of a driver
+ *
+ * At the end of the driver it is only saved when the search has been interrupted by a
+ * signal, so the run can go on later from there. If the driver kept the start of its
+ * iteration with retenerBusqueda, that state is saved instead of the current one.
+ * @param [in]      entorno		  		Population of the search
+ * @param [in]      estado		  		Counters of the driver
+ * @param [in]      final		  		Whether the driver has ended
+ */
+
+static void guardarBusqueda(Poblacion& entorno,const EstadoBusqueda& estado,bool final = false){
+    
+    Checkpoint* checkpoint = entorno.getCheckpoint();
+    if(checkpoint && (!final || Budget::interrumpido()))
+        checkpoint->guardar(entorno,estado,final);
+}
+
+
+/**
+ * @brief Keeps the search, if it has a checkpoint, at the start of an iteration of a driver with nested searches
+ *
+ * A signal stops the nested searches of the iteration partway, so the state saved when the
+ * search is interrupted is the one kept here, and the resumed run repeats the whole iteration.
+ * @param [in]      entorno		  		Population of the search
+ * @param [in]      estado		  		Counters of the driver
+ */
+
+static void retenerBusqueda(Poblacion& entorno,const EstadoBusqueda& estado){
+    
+    Checkpoint* checkpoint = entorno.getCheckpoint();
+    if(checkpoint)
+        checkpoint->retener(entorno,estado);
+}
+
+
+/**
+ * @brief Generational genetic algorithm, saving and resuming the search only when it is not nested in another driver
+ *
+ * @param [in]		nIndividuos			Number of individuals of the population that the algorithm will use
+ * @param [in]      evaluaciones	 	Number of evaluations of the individuals
+ * @param [in,out]  entorno		  		The individuals the algorithm will affect
+ * @param [in]      cruce 		  		Cross probability
+ * @param [in]      tipo 			  	Cross type, 0 = BLX		 1 = 2 Points
+ * @param [in]      mutacion 		  	Mutation probability
+ * @param [in]      guardar 		  	Whether the search is saved to the checkpoint of entorno
+ * @return 								The minimum interference calculated is returned
+ */
+
+static int generacional(int nIndividuos,int evaluaciones,Poblacion& entorno,double cruce,int tipo,double mutacion,
+        bool guardar){
+    
+    Budget& presupuesto = entorno.getBudget();
+    EstadoBusqueda estado = {presupuesto.getEvaluaciones() + evaluaciones, 20, entorno.getMejorInterferencia()};
+    if(guardar)
+        reanudarBusqueda(entorno,estado);
+    while(presupuesto.queda(estado.fin))
+    {
+        if(guardar)
+            guardarBusqueda(entorno,estado);
+        pasoGeneracional(entorno,cruce,tipo,mutacion,estado.generaciones,estado.guardia);
+    }
+    if(guardar)
+        guardarBusqueda(entorno,estado,true);
+    return entorno.getMejorInterferencia();
+}
 
 
 /**
  * @brief Generational genetic algorithm with elitism
  *
+ * Stops when the budget of the population has been charged with the given evaluations or
+ * its deadline has passed.
  * @param [in]		nIndividuos			Number of individuals of the population that the algorithm will use
  * @param [in]      evaluaciones	 	Number of evaluations of the individuals
  * @param [in,out]  entorno		  		The individuals the algorithm will affect
@@ -21,33 +147,25 @@
 
 int geneticoGeneracional(int nIndividuos,int evaluaciones,Poblacion& entorno,double cruce,int tipo,double mutacion){
     
-    int generaciones= 20;
-    int guardia = entorno.getMejor().getInterference();
-    while(evaluaciones >= 0){
-        
-        entorno.evolucionGeneracional(cruce,tipo,mutacion);
-        
-        if(guardia != entorno.getMejor().getInterference()){
-            generaciones = 20;
-            guardia=entorno.getMejor().getInterference();
-        } else {
-            --generaciones;
-            if(!generaciones){
-                entorno.reinicializar();
-                evaluaciones-=nIndividuos;
-                continue;
-            }
-        }
-        
-        if(entorno.comprobarRepetidos()){
-            entorno.reinicializar();
-            evaluaciones-=nIndividuos-1;
-            continue;
-        }
-        
-        evaluaciones-=nIndividuos*cruce;        
-    }
-    return entorno.getMejor().getInterference();
+    return generacional(nIndividuos,evaluaciones,entorno,cruce,tipo,mutacion,true);
+}
+
+
+/**
+ * @brief One step of the steady one genetic algorithm, restarting the population when it has too many repeated individuals
+ *
+ * @param [in,out]  entorno       	   The individuals the algorithm will affect
+ * @param [in]      parejas       	   Number of pairs that will be crossed
+ * @param [in]      tipo           	   Cross type, 0 = BLX		 1 = 2 Points
+ * @param [in]      mutacion       	   Mutation probability
+ */
+
+static void pasoEstacionario(Poblacion& entorno,int parejas,int tipo,double mutacion){
+    
+    entorno.evolucionEstacionaria(tipo,mutacion,parejas);
+    
+    if(entorno.comprobarRepetidos())
+        entorno.reinicializar();
 }
 
 
@@ -68,20 +186,175 @@ int geneticoEstacionario(int nIndividuos,int evaluaciones,Poblacion& entorno,int
     if(parejas <= 0)
         parejas = 1;
 
-    entorno.iniciarPoblacion(nIndividuos);
-    while(evaluaciones >= 0){
-        
-        entorno.evolucionEstacionaria(tipo,mutacion,parejas);
-        
-        if(entorno.comprobarRepetidos()){
-            entorno.reinicializar();
-            evaluaciones-=nIndividuos-1;
-            continue;
+    Budget& presupuesto = entorno.getBudget();
+    EstadoBusqueda estado = {0, 0, 0};
+    if(!reanudarBusqueda(entorno,estado))
+    {
+        entorno.iniciarPoblacion(nIndividuos);
+        estado.fin = presupuesto.getEvaluaciones() + evaluaciones;
+    }
+    while(presupuesto.queda(estado.fin))
+    {
+        guardarBusqueda(entorno,estado);
+        pasoEstacionario(entorno,parejas,tipo,mutacion);
+    }
+    guardarBusqueda(entorno,estado,true);
+    return entorno.getMejorInterferencia();
+}
+
+
+/**
+ * @brief Search state of one island of the island model
+ *
+ */
+
+struct EstadoIsla
+{
+    Poblacion* poblacion;	///< Population of the island
+    double fin;				///< Evaluations of the budget of the island at which it stops
+    int generaciones;		///< Generations left without improvement before restarting
+    int guardia;			///< Best interference seen so far
+};
+
+
+/**
+ * @brief Island model, each island evolves its own population on its own thread and every few generations
+ * sends its best individual to another island
+ *
+ * Each island charges its evaluations to its own budget, which shares the deadline of the budget
+ * of entorno and is added to it at the end. The evaluations are split evenly among the islands,
+ * so the whole model spends the same evaluations as a single population.
+ * @param [in]		nIslas				Number of islands
+ * @param [in]		intervalo			Generations between two migrations
+ * @param [in]		topologia			Migration topology, 0 = ring 1 = random
+ * @param [in]      evaluaciones	 	Number of evaluations of all the islands together
+ * @param [in,out]  entorno		  		Initial population, the best individual found is stored in it
+ * @param [in]      paso		  		One generation of the algorithm run on every island
+ * @return 								The minimum interference calculated is returned
+ */
+
+static int modeloIslas(int nIslas,int intervalo,int topologia,int evaluaciones,Poblacion& entorno,
+        const std::function<void(EstadoIsla&)>& paso){
+    
+    if(nIslas <= 0)
+        nIslas = 1;
+    if(intervalo <= 0)
+        intervalo = 1;
+
+    // Cada isla parte de la poblacion inicial, las demas conservan solo su mejor individuo
+    std::vector<EstadoIsla> islas(nIslas);
+    double cuota = (double)evaluaciones / nIslas;
+    for(int i = 0; i < nIslas; ++i)
+    {
+        islas[i].poblacion = new Poblacion(entorno);
+        islas[i].poblacion->setHilos(1);
+        islas[i].poblacion->getGenerador() = entorno.getGenerador().split(i);
+        islas[i].poblacion->getBudget().reiniciarContadores();
+        islas[i].poblacion->setIsla(i);
+        islas[i].fin = cuota;
+        if(i > 0)
+            islas[i].poblacion->reinicializar();
+        islas[i].generaciones = 20;
+        islas[i].guardia = islas[i].poblacion->getMejorInterferencia();
+    }
+
+    ThreadPool pool(nIslas);
+    bool quedan = true;
+    while(quedan)
+    {
+        // Epoca: cada isla evoluciona por su cuenta
+        pool.parallelFor(nIslas, [&](unsigned i) {
+            for(int g = 0; g < intervalo && islas[i].poblacion->getBudget().queda(islas[i].fin); ++g)
+                paso(islas[i]);
+        });
+
+        quedan = false;
+        for(int i = 0; i < nIslas; ++i)
+            if(islas[i].poblacion->getBudget().queda(islas[i].fin))
+                quedan = true;
+
+        // Migracion: el mejor de cada isla sustituye al peor de su destino
+        if(quedan && nIslas > 1)
+        {
+            std::vector<Especimen> emigrantes;
+            for(int i = 0; i < nIslas; ++i)
+                emigrantes.push_back(islas[i].poblacion->getMejor());
+
+            for(int i = 0; i < nIslas; ++i)
+            {
+                int destino = (i + 1)%nIslas;
+                if(topologia == 1)
+                    destino = (i + entorno.getGenerador().getInt(1, nIslas-1))%nIslas;
+                islas[destino].poblacion->recibirInmigrante(emigrantes[i]);
+            }
         }
-        
-        evaluaciones-=parejas*2;        
     }
-    return entorno.getMejor().getInterference();
+
+    int mejor = 0;
+    for(int i = 1; i < nIslas; ++i)
+        if(islas[i].poblacion->getMejorInterferencia() < islas[mejor].poblacion->getMejorInterferencia())
+            mejor = i;
+
+    entorno.recibirInmigrante(islas[mejor].poblacion->getMejor());
+    for(int i = 0; i < nIslas; ++i)
+    {
+        entorno.getBudget().sumar(islas[i].poblacion->getBudget());
+        delete islas[i].poblacion;
+    }
+
+    return entorno.getMejorInterferencia();
+}
+
+
+/**
+ * @brief Generational genetic algorithm with elitism run on several islands
+ *
+ * @param [in]		nIslas				Number of islands, one thread each
+ * @param [in]		intervalo			Generations between two migrations
+ * @param [in]		topologia			Migration topology, 0 = ring 1 = random
+ * @param [in]		nIndividuos			Number of individuals of the population that the algorithm will use
+ * @param [in]      evaluaciones	 	Number of evaluations of all the islands together
+ * @param [in,out]  entorno		  		The individuals the algorithm will affect
+ * @param [in]      cruce 		  		Cross probability
+ * @param [in]      tipo 			  	Cross type, 0 = BLX		 1 = 2 Points
+ * @param [in]      mutacion 		  	Mutation probability
+ * @return 								The minimum interference calculated is returned
+ */
+
+int islasGeneracional(int nIslas,int intervalo,int topologia,int nIndividuos,int evaluaciones,Poblacion& entorno,
+        double cruce,int tipo,double mutacion){
+    
+    return modeloIslas(nIslas,intervalo,topologia,evaluaciones,entorno,[&](EstadoIsla& isla) {
+        pasoGeneracional(*isla.poblacion,cruce,tipo,mutacion,isla.generaciones,isla.guardia);
+    });
+}
+
+
+/**
+ * @brief Steady one genetic algorithm run on several islands
+ *
+ * @param [in]		nIslas				Number of islands, one thread each
+ * @param [in]		intervalo			Generations between two migrations
+ * @param [in]		topologia			Migration topology, 0 = ring 1 = random
+ * @param [in]      nIndividuos	  	   	Number of individuals of the population that the algorithm will use
+ * @param [in]      evaluaciones 	   	Number of evaluations of all the islands together
+ * @param [in,out]  entorno       	   	The individuals the algorithm will affect
+ * @param [in]      parejas       	   	Number of pairs that will be crossed
+ * @param [in]      tipo           	   	Cross type, 0 = BLX		 1 = 2 Points
+ * @param [in]      mutacion       	   	Mutation probability
+ * @return  	   			 	       	The minimum interference calculated is returned
+ */
+
+int islasEstacionario(int nIslas,int intervalo,int topologia,int nIndividuos,int evaluaciones,Poblacion& entorno,
+        int parejas,int tipo,double mutacion){
+    
+    if(parejas <= 0)
+        parejas = 1;
+
+    entorno.iniciarPoblacion(nIndividuos);
+    return modeloIslas(nIslas,intervalo,topologia,evaluaciones,entorno,[&](EstadoIsla& isla) {
+        pasoEstacionario(*isla.poblacion,parejas,tipo,mutacion);
+    });
 }
 
 
@@ -90,22 +363,29 @@ int geneticoEstacionario(int nIndividuos,int evaluaciones,Poblacion& entorno,int
  *
  * @param [in,out]	esp				The element in which the lineal search will be used
  * @param [in]	 	numEval			Number of iterations made in the search
+ * @param [in,out]	rng				Random number generator
  * @return							The minimum interference calculated through the lineal search is returned.
  */
 
-int busquedaLineal( Especimen& esp, int numEval)
+int busquedaLineal( Especimen& esp, int numEval, RandomGenerator& rng)
 {
     int tam = esp.getSize();
-    int trans = getRandomInt(0,tam-1);
+    int trans = rng.getInt(0,tam-1);
     for(int i = 0; i < numEval; ++i)
     {
         int freqCount = 0;
-        while( freqCount < esp.getFreqRange(trans) && i < numEval)
+        int rango = esp.getFreqRange(trans);
+        while( freqCount < rango && i < numEval)
         {
-            if(esp.scanVal(trans, freqCount) < esp.getInterference())
+            // Solo se consulta la restriccion del transistor, el movimiento se aplica si mejora
+            int destino = (esp.getIndice(trans) + freqCount) % rango;
+            uint64_t comprobaciones = 0;
+            int delta = esp.deltaMovimiento(trans, destino, &comprobaciones);
+            if(esp.getBudget())
+                esp.getBudget()->contarParcial(comprobaciones);
+            if(delta < 0)
             {
-                esp.sigVal(trans, freqCount);
-                esp.evaluate();
+                esp.aplicarMovimiento(trans, destino, delta);
                 break;
             }
             ++freqCount;
@@ -119,6 +399,29 @@ int busquedaLineal( Especimen& esp, int numEval)
 }
 
 
+/**
+ * @brief Local search of the memetic algorithms
+ *
+ * Both searches get 200 steps: checked frequencies in busquedaLineal and moves in busquedaTabu.
+ * @param [in,out]	esp				The element in which the search will be used
+ * @param [in]	 	busqueda		Local search, 0 = busquedaLineal		1 = busquedaTabu
+ * @param [in]		domains			Frequencies available to each transistor
+ * @param [in]		adjacency		Restrictions incident to each transistor
+ * @param [in,out]	rng				Random number generator
+ * @param [in]		presupuesto		Budget of the population, checked by busquedaTabu to stop
+ * @param [in]		fin				Evaluations of presupuesto at which the memetic algorithm stops
+ * @return							The interference after the search
+ */
+
+static int busquedaLocal(Especimen& esp, int busqueda, DomainTable* domains, Adjacency* adjacency,
+        RandomGenerator& rng, const Budget& presupuesto, double fin)
+{
+    if (busqueda == 1)
+        return busquedaTabu(esp, domains, adjacency, 200, 200, rng, &presupuesto, fin);
+    return busquedaLineal(esp, 200, rng);
+}
+
+
 /**
  * @brief Memetic algorithm, every 10 iterations the algorithm is applied to the whole population
  *
@@ -128,40 +431,41 @@ int busquedaLineal( Especimen& esp, int numEval)
  * @param [in]		cruce				Cross probability
  * @param [in]		tipo				Cross type, 0 = BLX		 1 = 2 Points
  * @param [in]		mutacion			Mutation probability
+ * @param [in]		busqueda			Local search, 0 = busquedaLineal		1 = busquedaTabu
  * @return								The minimum interference calculated is returned
  */
 
-int am1010(int nIndividuos, int evaluaciones,Poblacion& entorno, double cruce, int tipo, double mutacion)
+int am1010(int nIndividuos, int evaluaciones,Poblacion& entorno, double cruce, int tipo, double mutacion,
+        int busqueda)
 {
-    int generaciones = 2;
-    int guardia = entorno.getMejor().getInterference();
-    while (evaluaciones >= 0)
+    Budget& presupuesto = entorno.getBudget();
+    EstadoBusqueda estado = {presupuesto.getEvaluaciones() + evaluaciones, 2, entorno.getMejorInterferencia()};
+    reanudarBusqueda(entorno, estado);
+    while (presupuesto.queda(estado.fin))
     {
-        if (!generaciones)
+        retenerBusqueda(entorno, estado);
+        if (!estado.generaciones)
             entorno.reinicializar();
         
-        geneticoGeneracional(20, 140, entorno, 0.7, tipo, 0.1);
-//        std::cout << "Nuevas 10 Gen ------------" << std::endl;
-        evaluaciones -= 140;
+        generacional(20, (int)std::ceil(std::min(140.0, estado.fin - presupuesto.getEvaluaciones())), entorno, 0.7, tipo, 0.1, false);
         
-        for (unsigned i = 0; i < entorno.mundo_->size(); ++i)
+        for (unsigned i = 0; i < entorno.mundo_->size() && presupuesto.queda(estado.fin); ++i)
         {
-//            std::cout << (*entorno.mundo_)[i].getInterference() << " --> ";
-            busquedaLineal((*entorno.mundo_)[i], 200);
-//            std::cout << (*entorno.mundo_)[i].getInterference() << std::endl;
+            busquedaLocal((*entorno.mundo_)[i], busqueda, entorno.domains_, entorno.adjacency_, entorno.rng_,
+                    presupuesto, estado.fin);
             entorno.actualizarMejor();
-            evaluaciones -= 200;
         }
         
-        if(guardia > entorno.getMejor().getInterference())
+        if(estado.guardia > entorno.getMejorInterferencia())
         {
-            generaciones = 2;
-            guardia = entorno.getMejor().getInterference();
+            estado.generaciones = 2;
+            estado.guardia = entorno.getMejorInterferencia();
         } else {
-            --generaciones;
+            --estado.generaciones;
         }
     }
-    return entorno.getMejor().getInterference();
+    guardarBusqueda(entorno, estado, true);
+    return entorno.getMejorInterferencia();
 }
 
 
@@ -174,43 +478,44 @@ int am1010(int nIndividuos, int evaluaciones,Poblacion& entorno, double cruce, i
  * @param [in]		cruce				Cross probability
  * @param [in]		tipo				Cross type, 0 = BLX		 1 = 2 Points
  * @param [in]		mutacion			Mutation probability
+ * @param [in]		busqueda			Local search, 0 = busquedaLineal		1 = busquedaTabu
  * @return								The minimum interference calculated is returned
  */
 
-int am1001(int nIndividuos, int evaluaciones,Poblacion& entorno, double cruce, int tipo, double mutacion)
+int am1001(int nIndividuos, int evaluaciones,Poblacion& entorno, double cruce, int tipo, double mutacion,
+        int busqueda)
 {
-    int generaciones = 2;
-    int guardia = entorno.getMejor().getInterference();
-    while (evaluaciones >= 0)
+    Budget& presupuesto = entorno.getBudget();
+    EstadoBusqueda estado = {presupuesto.getEvaluaciones() + evaluaciones, 2, entorno.getMejorInterferencia()};
+    reanudarBusqueda(entorno, estado);
+    while (presupuesto.queda(estado.fin))
     {
-        if (!generaciones)
+        retenerBusqueda(entorno, estado);
+        if (!estado.generaciones)
             entorno.reinicializar();
-        geneticoGeneracional(20, 140, entorno, 0.7, tipo, 0.1);
-//        std::cout << "Nuevas 10 Gen ------------" << std::endl;
-        evaluaciones -= 140;
+        generacional(20, (int)std::ceil(std::min(140.0, estado.fin - presupuesto.getEvaluaciones())), entorno, 0.7, tipo, 0.1, false);
         
-        for (int i = 0; i < entorno.mundo_->size()*0.1; ++i)
+        for (int i = 0; i < entorno.mundo_->size()*0.1 && presupuesto.queda(estado.fin); ++i)
         {
             int tamPoblacion = entorno.mundo_->size();
-            int start = getRandomInt(0, tamPoblacion-1);
+            int start = entorno.rng_.getInt(0, tamPoblacion-1);
             
-//            std::cout << (*entorno.mundo_)[i].getInterference() << " --> ";
-            busquedaLineal((*entorno.mundo_)[(start+i)%tamPoblacion], 200);
-//            std::cout << (*entorno.mundo_)[i].getInterference() << std::endl;
+            busquedaLocal((*entorno.mundo_)[(start+i)%tamPoblacion], busqueda, entorno.domains_, entorno.adjacency_,
+                    entorno.rng_, presupuesto, estado.fin);
             
             entorno.actualizarMejor();
-            evaluaciones -= 200;
         }
         
-        if(guardia > entorno.getMejor().getInterference())
+        if(estado.guardia > entorno.getMejorInterferencia())
         {
-            generaciones = 2;
-            guardia = entorno.getMejor().getInterference();
+            estado.generaciones = 2;
+            estado.guardia = entorno.getMejorInterferencia();
         } else {
-            --generaciones;
+            --estado.generaciones;
         }
     }
-    return entorno.getMejor().getInterference();
+    guardarBusqueda(entorno, estado, true);
+    return entorno.getMejorInterferencia();
 }
 
 
@@ -223,26 +528,28 @@ int am1001(int nIndividuos, int evaluaciones,Poblacion& entorno, double cruce, i
  * @param [in]		cruce				Cross probability
  * @param [in]		tipo				Cross type, 0 = BLX		 1 = 2 Points
  * @param [in]		mutacion			Mutation probability
+ * @param [in]		busqueda			Local search, 0 = busquedaLineal		1 = busquedaTabu
  * @return								The minimum interference calculated is returned
  */
 
-int am1001Mej(int nIndividuos, int evaluaciones,Poblacion& entorno, double cruce, int tipo, double mutacion)
+int am1001Mej(int nIndividuos, int evaluaciones,Poblacion& entorno, double cruce, int tipo, double mutacion,
+        int busqueda)
 {
-    int generaciones = 2;
-    int guardia = entorno.getMejor().getInterference();
-    while (evaluaciones >= 0)
+    Budget& presupuesto = entorno.getBudget();
+    EstadoBusqueda estado = {presupuesto.getEvaluaciones() + evaluaciones, 2, entorno.getMejorInterferencia()};
+    reanudarBusqueda(entorno, estado);
+    while (presupuesto.queda(estado.fin))
     {
+        retenerBusqueda(entorno, estado);
         
-         if (!generaciones)
+         if (!estado.generaciones)
             entorno.reinicializar();
          
-        geneticoGeneracional(20, 140, entorno, 0.7, tipo, 0.1);
-//        std::cout << "Nuevas 10 Gen ------------" << std::endl;
-        evaluaciones -= 140;
+        generacional(20, (int)std::ceil(std::min(140.0, estado.fin - presupuesto.getEvaluaciones())), entorno, 0.7, tipo, 0.1, false);
         
         std::set<int> vistos;
         
-        for (int i = 0; i < entorno.mundo_->size()*0.1; ++i)
+        for (int i = 0; i < entorno.mundo_->size()*0.1 && presupuesto.queda(estado.fin); ++i)
         {
             int mejor = 0;
             int vMejor = INT_MAX;
@@ -256,22 +563,168 @@ int am1001Mej(int nIndividuos, int evaluaciones,Poblacion& entorno, double cruce
 
             vistos.insert(mejor);
 
-//            std::cout << (*entorno.mundo_)[mejor].getInterference() << " --> ";
-            busquedaLineal((*entorno.mundo_)[mejor], 200);
-//            std::cout << (*entorno.mundo_)[mejor].getInterference() << std::endl;
+            busquedaLocal((*entorno.mundo_)[mejor], busqueda, entorno.domains_, entorno.adjacency_, entorno.rng_,
+                    presupuesto, estado.fin);
             
             entorno.actualizarMejor();
-            evaluaciones -= 200;
         }
         
-        if(guardia > entorno.getMejor().getInterference())
+        if(estado.guardia > entorno.getMejorInterferencia())
         {
-            generaciones = 2;
-            guardia = entorno.getMejor().getInterference();
+            estado.generaciones = 2;
+            estado.guardia = entorno.getMejorInterferencia();
         } else {
-            --generaciones;
+            --estado.generaciones;
         }
     }
-    return entorno.getMejor().getInterference();
+    guardarBusqueda(entorno, estado, true);
+    return entorno.getMejorInterferencia();
+}
+
+
+/**
+ * @brief Tabu search from the best individual of the population
+ *
+ * Each round runs busquedaTabu from the best individual found so far, with an empty tabu
+ * list, until it stagnates, and puts its result back in the population. So the search
+ * restarts from the best individual each time it stops improving, and between two rounds
+ * the population holds the whole state to save it to a checkpoint.
+ * @param [in]		evaluaciones		Number of evaluations of the individuals
+ * @param [in,out]	entorno				Population, initialized, whose best individual is improved
+ * @return								The minimum interference calculated is returned
+ */
+
+int algoritmoTabu(int evaluaciones, Poblacion& entorno)
+{
+    Budget& presupuesto = entorno.getBudget();
+    EstadoBusqueda estado = {presupuesto.getEvaluaciones() + evaluaciones, 0, entorno.getMejorInterferencia()};
+    reanudarBusqueda(entorno, estado);
+    
+    // Una ronda acaba tras 10 movimientos por transistor sin mejorar, o tras 2^20 para guardar a menudo
+    int estancamiento = std::max(1000, 10 * (int)entorno.domains_->numTransistors());
+    while (presupuesto.queda(estado.fin) && estado.guardia > 0)
+    {
+        retenerBusqueda(entorno, estado);
+        Especimen esp = entorno.getMejor();
+        busquedaTabu(esp, entorno.domains_, entorno.adjacency_, 1 << 20, estancamiento, entorno.rng_,
+                &presupuesto, estado.fin);
+        entorno.recibirInmigrante(esp);
+        estado.guardia = entorno.getMejorInterferencia();
+    }
+    guardarBusqueda(entorno, estado, true);
+    return entorno.getMejorInterferencia();
 }
 
+
+/**
+ * @brief Solves each connected component of the instance on its own and joins the results
+ *
+ * Every component gets its own population, seeded from the generator of entorno, and the
+ * same number of evaluations, which are counted in evaluations of the component: so the
+ * restrictions checked for each one are proportional to its size and add up to the ones of
+ * a search over the whole instance. The components are shared among the threads, the
+ * biggest first, and when there are fewer components than threads each population evaluates
+ * its children with the threads left. The time left is shared the same way: when a
+ * component starts it gets the share of its restrictions among the components not started
+ * yet, times the threads that will run them at once.
+ *
+ * Each population also receives the best individual of entorno restricted to its component,
+ * so no component ends worse than it started, and reports its improvements into the
+ * reporter of entorno. The transistors without restrictions, and the components that could
+ * not start before the search was stopped, keep the frequencies they have in the best
+ * individual of entorno, where the best assignment of every component is then copied.
+ * @param [in,out]	componentes		Components of the instance of entorno, given by InstanceSplitter
+ * @param [in]		hilos			Threads that solve components at once, 0 uses every hardware thread
+ * @param [in,out]	entorno			Population of the whole instance, initialized
+ * @param [in]		resolver		Algorithm that improves a population, initialized, of a component
+ * @return							The minimum interference calculated is returned
+ */
+
+int modeloComponentes(std::vector<SubInstance>& componentes, unsigned hilos, Poblacion& entorno,
+        const std::function<int(Poblacion&)>& resolver)
+{
+    unsigned n = componentes.size();
+    std::vector<unsigned> orden(n);
+    std::vector<uint64_t> semillas(n);
+    uint64_t pendientes = 0;
+    for (unsigned c = 0; c < n; ++c)
+    {
+        orden[c] = c;
+        semillas[c] = entorno.getGenerador().split(c).next();
+        pendientes += componentes[c].restrictions.size();
+    }
+    std::stable_sort(orden.begin(), orden.end(), [&](unsigned a, unsigned b) {
+        return componentes[a].restrictions.size() > componentes[b].restrictions.size();
+    });
+
+    if (hilos == 0)
+        hilos = std::thread::hardware_concurrency();
+    if (hilos == 0)
+        hilos = 1;
+    unsigned simultaneas = std::max(1u, std::min(hilos, n));
+    unsigned hilosComponente = std::max(1u, hilos / simultaneas);
+
+    Especimen inicial = entorno.getMejor();
+    std::vector<std::vector<int>> indices(n);
+    std::vector<Budget> presupuestos(n);
+    std::mutex cerrojo;
+    unsigned sinEmpezar = n;
+    ThreadPool pool(simultaneas);
+    pool.parallelFor(n, [&](unsigned i) {
+        unsigned c = orden[i];
+        SubInstance& sub = componentes[c];
+        
+        // Parte del tiempo que queda proporcional a las restricciones de la componente
+        double segundos;
+        {
+            std::lock_guard<std::mutex> lock(cerrojo);
+            segundos = entorno.getBudget().getSegundosRestantes();
+            if (segundos > 0)
+                segundos *= std::min(1.0, (double)std::min(simultaneas, sinEmpezar)
+                        * sub.restrictions.size() / pendientes);
+            pendientes -= sub.restrictions.size();
+            --sinEmpezar;
+        }
+        if (segundos == 0 || entorno.getBudget().agotado())
+            return;
+        
+        Poblacion poblacion(&sub.domains, &sub.restrictions, &sub.adjacency, semillas[c], hilosComponente);
+        Budget& presupuesto = poblacion.getBudget();
+        presupuesto = entorno.getBudget();
+        presupuesto.setTamEvaluacion(sub.restrictions.size());
+        presupuesto.reiniciarContadores();
+        if (segundos > 0)
+            presupuesto.setLimiteTiempo(segundos);
+        
+        poblacion.iniciarPoblacion(20);
+        Especimen partida = poblacion.getMejor();
+        for (unsigned t = 0; t < sub.transistors.size(); ++t)
+            partida.setIndice(t, inicial.getIndice(sub.transistors[t]));
+        partida.evaluate();
+        
+        std::unique_ptr<ProgressReporter> progreso;
+        if (entorno.getProgreso())
+        {
+            progreso.reset(new ProgressReporter(entorno.getProgreso(), &sub.transistors, partida.getInterference()));
+            poblacion.setProgreso(progreso.get());
+        }
+        poblacion.recibirInmigrante(partida);
+        resolver(poblacion);
+        
+        Especimen mejor = poblacion.getMejor();
+        for (unsigned t = 0; t < sub.transistors.size(); ++t)
+            indices[c].push_back(mejor.getIndice(t));
+        presupuestos[c] = presupuesto;
+    });
+
+    Especimen unido = inicial;
+    for (unsigned c = 0; c < n; ++c)
+    {
+        for (unsigned t = 0; t < indices[c].size(); ++t)
+            unido.setIndice(componentes[c].transistors[t], indices[c][t]);
+        entorno.getBudget().sumar(presupuestos[c]);
+    }
+    unido.evaluate();
+    entorno.recibirInmigrante(unido);
+    return entorno.getMejorInterferencia();
+}
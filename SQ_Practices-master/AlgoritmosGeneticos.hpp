@@ -8,6 +8,9 @@
 #define ALGORITMOSGENETICOS_HPP
 
 #include "Poblacion.hpp"
+#include "Checkpoint.hpp"
+#include "InstanceSplitter.hpp"
+#include <functional>
 
 
 
@@ -16,5 +19,18 @@ int geneticoGeneracional(int nIndividuos, int evaluaciones,Poblacion& entorno, d
 
 int geneticoEstacionario(int nIndividuos, int evaluaciones,Poblacion& entorno, int parejas, int tipo, double mutacion);
 
+
+int islasGeneracional(int nIslas, int intervalo, int topologia, int nIndividuos, int evaluaciones,Poblacion& entorno,
+        double cruce, int tipo, double mutacion);
+
+
+int islasEstacionario(int nIslas, int intervalo, int topologia, int nIndividuos, int evaluaciones,Poblacion& entorno,
+        int parejas, int tipo, double mutacion);
+
+
+int modeloComponentes(std::vector<SubInstance>& componentes, unsigned hilos, Poblacion& entorno,
+        const std::function<int(Poblacion&)>& resolver);
+
+
 #endif /* ALGORITMOSGENETICOS_HPP */
 
@@ -0,0 +1,73 @@
+/**
+ * @file BinaryStream.hpp
+ * @brief Writer and reader of plain values in a byte buffer
+ *
+ */
+
+#ifndef BINARYSTREAM_HPP
+#define BINARYSTREAM_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Appends plain values to a byte buffer, in the representation of the machine
+ */
+
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::vector<char>& datos) : datos_(datos) {}
+
+    template <class T>
+    void valor(const T& v) { tabla(&v, 1); }
+
+    template <class T>
+    void tabla(const T* v, size_t n)
+    {
+        const char* p = reinterpret_cast<const char*>(v);
+        datos_.insert(datos_.end(), p, p + n * sizeof(T));
+    }
+
+private:
+    std::vector<char>& datos_;			///< Buffer the values are appended to
+};
+
+
+/**
+ * @brief Reads in order the values written by a BinaryWriter
+ *
+ * Reading past the end of the buffer throws a runtime_error instead of reading garbage.
+ */
+
+class BinaryReader {
+public:
+    BinaryReader(const char* datos, size_t tam) : pos_(datos), fin_(datos + tam) {}
+
+    template <class T>
+    T valor()
+    {
+        T v;
+        tabla(&v, 1);
+        return v;
+    }
+
+    template <class T>
+    void tabla(T* v, size_t n)
+    {
+        if (n > (size_t)(fin_ - pos_) / sizeof(T))
+            throw std::runtime_error("Truncated checkpoint");
+        if (n)
+            std::memcpy(v, pos_, n * sizeof(T));
+        pos_ += n * sizeof(T);
+    }
+
+    size_t restantes() const { return fin_ - pos_; }
+
+private:
+    const char* pos_;					///< Next byte to read
+    const char* fin_;					///< End of the buffer
+};
+
+#endif /* BINARYSTREAM_HPP */
@@ -0,0 +1,279 @@
+/**
+ * @file Budget.cpp
+ * @brief Sources for the class Budget
+ *
+ */
+
+#include "Budget.hpp"
+
+std::atomic<bool> Budget::interrumpido_(false);
+
+/**
+ * @brief Default constructor, no evaluations made and no deadline
+ *
+ */
+
+Budget::Budget() : comprobaciones_(0), completas_(0), parciales_(0), tamEvaluacion_(0),
+        inicio_(std::chrono::steady_clock::now()), limite_(inicio_), conLimite_(false)
+{
+}
+
+
+/**
+ * @brief Copy constructor
+ *
+ * @param [in]	orig	budget to copy, counters and deadline
+ */
+
+Budget::Budget(const Budget& orig) : comprobaciones_(orig.comprobaciones_.load()),
+        completas_(orig.completas_.load()), parciales_(orig.parciales_.load()),
+        tamEvaluacion_(orig.tamEvaluacion_), inicio_(orig.inicio_), limite_(orig.limite_),
+        conLimite_(orig.conLimite_)
+{
+}
+
+
+/**
+ * @brief Assignment operator
+ *
+ * @param [in]	orig	budget to copy, counters and deadline
+ * @return this budget
+ */
+
+Budget& Budget::operator=(const Budget& orig)
+{
+    comprobaciones_ = orig.comprobaciones_.load();
+    completas_ = orig.completas_.load();
+    parciales_ = orig.parciales_.load();
+    tamEvaluacion_ = orig.tamEvaluacion_;
+    inicio_ = orig.inicio_;
+    limite_ = orig.limite_;
+    conLimite_ = orig.conLimite_;
+    return *this;
+}
+
+
+/**
+ * @brief Sets the number of restrictions checked by a full evaluation
+ *
+ * @param [in]	restricciones	number of restrictions of the instance
+ */
+
+void Budget::setTamEvaluacion(uint64_t restricciones)
+{
+    tamEvaluacion_ = restricciones;
+}
+
+
+/**
+ * @brief Sets a deadline counted from now
+ *
+ * @param [in]	segundos	seconds left, 0 or less removes the deadline
+ */
+
+void Budget::setLimiteTiempo(double segundos)
+{
+    conLimite_ = segundos > 0;
+    limite_ = std::chrono::steady_clock::now()
+            + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(segundos));
+}
+
+
+/**
+ * @brief Charges a full evaluation
+ *
+ */
+
+void Budget::contarCompleta()
+{
+    completas_.fetch_add(1, std::memory_order_relaxed);
+    comprobaciones_.fetch_add(tamEvaluacion_, std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief Charges a partial evaluation
+ *
+ * @param [in]	comprobaciones	restrictions checked by the evaluation
+ */
+
+void Budget::contarParcial(uint64_t comprobaciones)
+{
+    parciales_.fetch_add(1, std::memory_order_relaxed);
+    comprobaciones_.fetch_add(comprobaciones, std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief Adds the evaluations charged to another budget
+ *
+ * @param [in]	otro	budget whose counters are added
+ */
+
+void Budget::sumar(const Budget& otro)
+{
+    comprobaciones_ += otro.comprobaciones_.load();
+    completas_ += otro.completas_.load();
+    parciales_ += otro.parciales_.load();
+}
+
+
+/**
+ * @brief Sets the counters to 0, keeping the deadline
+ *
+ */
+
+void Budget::reiniciarContadores()
+{
+    comprobaciones_ = 0;
+    completas_ = 0;
+    parciales_ = 0;
+}
+
+
+/**
+ * @brief Writes the counters and the time used to a checkpoint
+ *
+ * @param [in,out]	estado	checkpoint being written
+ */
+
+void Budget::guardarEstado(BinaryWriter& estado) const
+{
+    estado.valor(comprobaciones_.load());
+    estado.valor(completas_.load());
+    estado.valor(parciales_.load());
+    estado.valor(getSegundos());
+}
+
+
+/**
+ * @brief Restores the counters and the time used from a checkpoint, keeping the deadline
+ *
+ * @param [in,out]	estado	checkpoint being read
+ */
+
+void Budget::cargarEstado(BinaryReader& estado)
+{
+    comprobaciones_ = estado.valor<uint64_t>();
+    completas_ = estado.valor<uint64_t>();
+    parciales_ = estado.valor<uint64_t>();
+    inicio_ = std::chrono::steady_clock::now()
+            - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(estado.valor<double>()));
+}
+
+
+/**
+ * @brief Gets the evaluations made, partial ones weighted by the restrictions they checked
+ *
+ * @return evaluations in units of full evaluations
+ */
+
+double Budget::getEvaluaciones() const
+{
+    if (!tamEvaluacion_)
+        return completas_.load(std::memory_order_relaxed);
+    return (double)comprobaciones_.load(std::memory_order_relaxed) / tamEvaluacion_;
+}
+
+
+/**
+ * @brief Gets the number of full evaluations
+ *
+ * @return full evaluations made
+ */
+
+uint64_t Budget::getCompletas() const
+{
+    return completas_.load(std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief Gets the number of partial evaluations
+ *
+ * @return partial evaluations made
+ */
+
+uint64_t Budget::getParciales() const
+{
+    return parciales_.load(std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief Gets the time since the search started
+ *
+ * @return seconds
+ */
+
+double Budget::getSegundos() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio_).count();
+}
+
+
+/**
+ * @brief Gets the time left before the deadline
+ *
+ * @return seconds, 0 if the deadline has passed, a negative value if there is no deadline
+ */
+
+double Budget::getSegundosRestantes() const
+{
+    if (!conLimite_)
+        return -1;
+    double segundos = std::chrono::duration<double>(limite_ - std::chrono::steady_clock::now()).count();
+    return segundos > 0 ? segundos : 0;
+}
+
+
+/**
+ * @brief Whether the deadline has passed or the search has been interrupted
+ *
+ * @return true if the search has to stop
+ */
+
+bool Budget::agotado() const
+{
+    if (interrumpido_.load(std::memory_order_relaxed))
+        return true;
+    return conLimite_ && std::chrono::steady_clock::now() >= limite_;
+}
+
+
+/**
+ * @brief Whether a search that must stop after a number of evaluations can go on
+ *
+ * @param [in]	fin		value of getEvaluaciones at which the search stops
+ * @return true if fin has not been reached and the deadline has not passed
+ */
+
+bool Budget::queda(double fin) const
+{
+    return getEvaluaciones() < fin && !agotado();
+}
+
+
+/**
+ * @brief Exhausts every budget, so every search stops at its next check
+ *
+ * It is safe to call it from a signal handler.
+ */
+
+void Budget::interrumpir()
+{
+    interrumpido_.store(true, std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief Whether the searches have been interrupted
+ *
+ * @return true if interrumpir has been called
+ */
+
+bool Budget::interrumpido()
+{
+    return interrumpido_.load(std::memory_order_relaxed);
+}
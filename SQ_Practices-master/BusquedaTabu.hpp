@@ -0,0 +1,17 @@
+/**
+ * @file BusquedaTabu.hpp
+ * @brief Declaration of the tabu search over an individual
+ *
+ */
+
+#ifndef BUSQUEDATABU_HPP
+#define BUSQUEDATABU_HPP
+
+#include "Especimen.hpp"
+#include "Random.hpp"
+#include "Budget.hpp"
+
+int busquedaTabu(Especimen& esp, DomainTable* domains, Adjacency* adjacency, int movimientos,
+        int estancamiento, RandomGenerator& rng, const Budget* presupuesto = nullptr, double fin = 0);
+
+#endif /* BUSQUEDATABU_HPP */
@@ -0,0 +1,278 @@
+/**
+ * @file Checkpoint.cpp
+ * @brief Sources for the class Checkpoint
+ *
+ */
+
+#include "Checkpoint.hpp"
+
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <unistd.h>
+
+/**
+ * @brief Version of the format, written after the magic string "SQCKPT"
+ */
+static const uint32_t versionCheckpoint = 1;
+
+
+/**
+ * @brief Default constructor
+ *
+ * @param [in]	path		file where the checkpoints are written, empty to only resume from one
+ * @param [in]	intervalo	seconds between two checkpoints
+ * @param [in]	modelo		algorithm and cross of the search, a checkpoint of another one can not be resumed
+ */
+
+Checkpoint::Checkpoint(const std::string& path, double intervalo, const std::string& modelo) :
+        path_(path), modelo_(modelo), inicial_(INT_MAX), inicioPoblacion_(0), pendiente_(false),
+        ocupado_(false), parar_(false)
+{
+    intervalo_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(intervalo));
+    ultimo_ = std::chrono::steady_clock::now();
+    if (!path_.empty())
+        hilo_ = std::thread(&Checkpoint::escritor, this);
+}
+
+
+/**
+ * @brief Destroyer
+ *
+ * Waits until the last snapshot taken has been written
+ */
+
+Checkpoint::~Checkpoint()
+{
+    if (hilo_.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(cerrojo_);
+            parar_ = true;
+        }
+        aviso_.notify_all();
+        hilo_.join();
+    }
+}
+
+
+/**
+ * @brief Reads a checkpoint to resume its search
+ *
+ * @param [in]	path	file of the checkpoint
+ */
+
+void Checkpoint::cargar(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Can not read the checkpoint " + path);
+    leido_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    BinaryReader lectura(leido_.data(), leido_.size());
+    char magic[8];
+    lectura.tabla(magic, 8);
+    if (std::memcmp(magic, "SQCKPT", 7) != 0 || lectura.valor<uint32_t>() != versionCheckpoint)
+        throw std::runtime_error(path + " is not a checkpoint of this version");
+    inicial_ = lectura.valor<int>();
+    std::string modelo(lectura.valor<uint64_t>(), ' ');
+    lectura.tabla(&modelo[0], modelo.size());
+    if (modelo != modelo_)
+        throw std::runtime_error("The checkpoint is of a search with " + modelo + ", not " + modelo_);
+    estadoLeido_ = lectura.valor<EstadoBusqueda>();
+
+    inicioPoblacion_ = leido_.size() - lectura.restantes();
+    pendiente_ = true;
+}
+
+
+/**
+ * @brief Replaces the state of a population by the one of the checkpoint read
+ *
+ * @param [in,out]	poblacion	population of the search
+ */
+
+void Checkpoint::restaurar(Poblacion& poblacion)
+{
+    BinaryReader lectura(leido_.data() + inicioPoblacion_, leido_.size() - inicioPoblacion_);
+    poblacion.cargarEstado(lectura);
+    if (lectura.restantes())
+        throw std::runtime_error("Unexpected data at the end of the checkpoint");
+}
+
+
+/**
+ * @brief Gives a driver the counters it had when the checkpoint read was taken
+ *
+ * Only the first driver that asks gets them, the following ones start as usual.
+ * @param [out]	estado	counters of the driver, only written if there is a checkpoint to resume
+ * @return true if the search is resumed and the population must not be initialized again
+ */
+
+bool Checkpoint::reanudar(EstadoBusqueda& estado)
+{
+    if (!pendiente_)
+        return false;
+    estado = estadoLeido_;
+    pendiente_ = false;
+    leido_.clear();
+    leido_.shrink_to_fit();
+    return true;
+}
+
+
+/**
+ * @brief Takes a snapshot of the search if it is time to, and hands it to the writer thread
+ *
+ * @param [in]	poblacion	population of the search
+ * @param [in]	estado		counters of the driver
+ * @param [in]	ahora		take it even if the interval has not passed, waiting for the previous one.
+ * 							If retener kept the state of the iteration, that one is written instead
+ */
+
+void Checkpoint::guardar(const Poblacion& poblacion, const EstadoBusqueda& estado, bool ahora)
+{
+    if (path_.empty())
+        return;
+
+    std::chrono::steady_clock::time_point momento = std::chrono::steady_clock::now();
+    if (ahora)
+    {
+        std::unique_lock<std::mutex> lock(cerrojo_);
+        aviso_.wait(lock, [this]() { return !ocupado_.load(); });
+    } else if (momento - ultimo_ < intervalo_ || ocupado_.load(std::memory_order_acquire))
+        return;
+    ultimo_ = momento;
+
+    if (ahora && !retenido_.empty())
+        buffer_.swap(retenido_);
+    else
+        serializar(poblacion, estado, buffer_);
+    entregar();
+}
+
+
+/**
+ * @brief Keeps the state at the start of an iteration, and takes a snapshot of it if it is time to
+ *
+ * @param [in]	poblacion	population of the search
+ * @param [in]	estado		counters of the driver
+ */
+
+void Checkpoint::retener(const Poblacion& poblacion, const EstadoBusqueda& estado)
+{
+    if (path_.empty())
+        return;
+
+    serializar(poblacion, estado, retenido_);
+    std::chrono::steady_clock::time_point momento = std::chrono::steady_clock::now();
+    if (momento - ultimo_ < intervalo_ || ocupado_.load(std::memory_order_acquire))
+        return;
+    ultimo_ = momento;
+
+    buffer_.assign(retenido_.begin(), retenido_.end());
+    entregar();
+}
+
+
+/**
+ * @brief Writes the state of the search to a buffer in the format of the file
+ *
+ * @param [in]	poblacion	population of the search
+ * @param [in]	estado		counters of the driver
+ * @param [out]	destino		buffer, its capacity is reused
+ */
+
+void Checkpoint::serializar(const Poblacion& poblacion, const EstadoBusqueda& estado, std::vector<char>& destino)
+{
+    destino.clear();
+    BinaryWriter escritura(destino);
+    escritura.tabla("SQCKPT\0", 8);
+    escritura.valor(versionCheckpoint);
+    escritura.valor(inicial_);
+    escritura.valor((uint64_t)modelo_.size());
+    escritura.tabla(modelo_.data(), modelo_.size());
+    escritura.valor(estado);
+    poblacion.guardarEstado(escritura);
+}
+
+
+/**
+ * @brief Hands buffer_ to the writer thread, which must be idle
+ */
+
+void Checkpoint::entregar()
+{
+    {
+        std::lock_guard<std::mutex> lock(cerrojo_);
+        escribiendo_.swap(buffer_);
+        ocupado_.store(true, std::memory_order_release);
+    }
+    aviso_.notify_all();
+}
+
+
+/**
+ * @brief Sets the best interference of the initial population, shown again when resuming
+ *
+ * @param [in]	inicial		interference
+ */
+
+void Checkpoint::setInicial(int inicial)
+{
+    inicial_ = inicial;
+}
+
+
+/**
+ * @brief Gets the best interference of the initial population of the checkpoint read
+ *
+ * @return interference
+ */
+
+int Checkpoint::getInicial() const
+{
+    return inicial_;
+}
+
+
+/**
+ * @brief Body of the writer thread
+ *
+ * Writes each snapshot under a temporary name and renames it, so the file always holds a
+ * complete checkpoint even if the process dies while writing.
+ */
+
+void Checkpoint::escritor()
+{
+    std::string temporal = path_ + ".tmp" + std::to_string(getpid());
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(cerrojo_);
+            aviso_.wait(lock, [this]() { return parar_ || ocupado_.load(); });
+            if (!ocupado_.load())
+                return;
+        }
+
+        FILE* file = std::fopen(temporal.c_str(), "wb");
+        bool ok = file && std::fwrite(escribiendo_.data(), 1, escribiendo_.size(), file) == escribiendo_.size();
+        ok = file && std::fflush(file) == 0 && fsync(fileno(file)) == 0 && ok;
+        ok = file && std::fclose(file) == 0 && ok;
+        if (!ok || std::rename(temporal.c_str(), path_.c_str()) != 0)
+        {
+            std::remove(temporal.c_str());
+            std::fprintf(stderr, "Can not write the checkpoint %s\n", path_.c_str());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(cerrojo_);
+            ocupado_.store(false, std::memory_order_release);
+        }
+        aviso_.notify_all();
+    }
+}
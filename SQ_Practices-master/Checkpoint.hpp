@@ -0,0 +1,90 @@
+/**
+ * @file Checkpoint.hpp
+ * @brief Headers declarations for class Checkpoint
+ *
+ */
+
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Poblacion.hpp"
+
+/**
+ * @brief Counters of a driver of AlgoritmosGeneticos that are kept between iterations
+ */
+struct EstadoBusqueda
+{
+    double fin;				///< Evaluations of the budget at which the search stops
+    int generaciones;		///< Generations left without improvement before restarting
+    int guardia;			///< Best interference seen so far
+};
+
+
+/**
+ * @brief Binary snapshot of a running search, to resume it after the process dies
+ *
+ * The drivers call guardar at the start of each iteration of their main loop, where
+ * the population and the EstadoBusqueda are the whole state of the search, so a run
+ * resumed from a checkpoint makes exactly the same steps as the run that wrote it.
+ * Every few seconds the state is copied to a buffer and a background thread writes it
+ * under a temporary name and renames it; if the previous one is still being written the
+ * snapshot is skipped, so the search never waits for the disk.
+ *
+ * A signal can cut short the nested searches of an iteration, so the drivers that run them
+ * call retener instead, which keeps in memory the state at the start of each iteration, and
+ * the snapshot taken when the search is interrupted is that one instead of the half done
+ * iteration.
+ */
+
+class Checkpoint {
+public:
+    Checkpoint(const std::string& path, double intervalo, const std::string& modelo);
+    Checkpoint(const Checkpoint& orig) = delete;
+    Checkpoint& operator=(const Checkpoint& orig) = delete;
+    virtual ~Checkpoint();
+
+    void cargar(const std::string& path);
+    void restaurar(Poblacion& poblacion);
+    bool reanudar(EstadoBusqueda& estado);
+
+    void guardar(const Poblacion& poblacion, const EstadoBusqueda& estado, bool ahora = false);
+    void retener(const Poblacion& poblacion, const EstadoBusqueda& estado);
+
+    void setInicial(int inicial);
+    int getInicial() const;
+
+private:
+    void serializar(const Poblacion& poblacion, const EstadoBusqueda& estado, std::vector<char>& destino);
+    void entregar();
+    void escritor();
+
+    std::string path_;									///< File where the checkpoints are written, empty to not write them
+    std::chrono::steady_clock::duration intervalo_;		///< Time between two checkpoints
+    std::chrono::steady_clock::time_point ultimo_;		///< When the last checkpoint was taken
+    std::string modelo_;								///< Algorithm and cross of the search, checked when resuming
+    int inicial_;										///< Best interference of the initial population
+
+    std::vector<char> leido_;							///< Checkpoint read to resume the search
+    size_t inicioPoblacion_;							///< Position of the population in leido_
+    EstadoBusqueda estadoLeido_;						///< Counters of the driver in leido_
+    bool pendiente_;									///< Whether the driver has not resumed yet
+
+    std::vector<char> buffer_;							///< Snapshot being built by the search
+    std::vector<char> retenido_;						///< State at the start of the current iteration, empty if not kept
+    std::vector<char> escribiendo_;						///< Snapshot being written by the writer thread
+    std::atomic<bool> ocupado_;							///< Whether the writer thread has a snapshot to write
+    bool parar_;										///< Tells the writer thread to end
+    std::mutex cerrojo_;								///< Protects ocupado_ changes and parar_ for the condition
+    std::condition_variable aviso_;						///< Wakes up the writer thread and guardar
+    std::thread hilo_;									///< Writer thread
+};
+
+#endif /* CHECKPOINT_HPP */
@@ -0,0 +1,173 @@
+/**
+ * @file ConflictSet.cpp
+ * @brief Sources for the class ConflictSet
+ *
+ */
+
+#include "ConflictSet.hpp"
+
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+
+/**
+ * @brief Default constructor
+ *
+ * Builds the set of the current genes of the individual
+ *
+ * @param [in]	domains		Frequencies available to each transistor
+ * @param [in]	adjacency	Restrictions incident to each transistor
+ * @param [in]	especimen	Individual the set describes, it must outlive the set
+ */
+
+ConflictSet::ConflictSet(DomainTable* domains, Adjacency* adjacency, Especimen* especimen) :
+        domains_(domains), adjacency_(adjacency), especimen_(especimen)
+{
+    unsigned numTrans = domains_->numTransistors();
+    costes_.resize(numTrans);
+    posConflicto_.assign(numTrans, -1);
+    reconstruir();
+}
+
+
+/**
+ * @brief Computes the cost of every transistor again from the genes of the individual
+ *
+ * Needed after the individual is changed by anything else than mover. The cost of a
+ * transistor can never be larger than the sum of its restrictions, so checking that sum
+ * once keeps every cost safe from overflow.
+ */
+
+void ConflictSet::reconstruir()
+{
+    unsigned numTrans = domains_->numTransistors();
+    for (unsigned t = 0; t < numTrans; ++t)
+    {
+        int frecuencia = especimen_->getFrecuencia(t);
+        int64_t maximo = 0;
+        int coste = 0;
+        for (unsigned k = adjacency_->offsets[t]; k < adjacency_->offsets[t+1]; ++k)
+        {
+            const AdjRestriction& r = adjacency_->entries[k];
+            maximo += r.interference;
+            if( r.bound < std::abs(frecuencia - especimen_->getFrecuencia(r.neighbour)) )
+                coste += r.interference;
+        }
+        if (maximo > INT_MAX)
+            throw std::overflow_error("Integer Overflow");
+        costes_[t] = coste;
+        marcarConflicto(t);
+    }
+
+    if (especimen_->getBudget())
+        especimen_->getBudget()->contarParcial(adjacency_->entries.size());
+}
+
+
+/**
+ * @brief Moves a transistor of the individual to another frequency and updates the set
+ *
+ * The change of the cost of each neighbour and of the interference of the individual come
+ * out of the same pass over the restrictions of the transistor.
+ * @param [in]	trans	transistor
+ * @param [in]	destino	index in the domain of trans of the new frequency
+ */
+
+void ConflictSet::mover(unsigned trans, int destino)
+{
+    int actual = especimen_->getIndice(trans);
+    if (destino == actual)
+        return;
+
+    int viejo = especimen_->getFrecuencia(trans);
+    int nuevo = domains_->domain(trans)[destino];
+    int delta = 0;
+    for (unsigned k = adjacency_->offsets[trans]; k < adjacency_->offsets[trans+1]; ++k)
+    {
+        const AdjRestriction& r = adjacency_->entries[k];
+        int vecino = especimen_->getFrecuencia(r.neighbour);
+        int cambio = 0;
+        if( r.bound < std::abs(viejo - vecino) )
+            cambio -= r.interference;
+        if( r.bound < std::abs(nuevo - vecino) )
+            cambio += r.interference;
+        if (cambio != 0)
+        {
+            costes_[r.neighbour] += cambio;
+            delta += cambio;
+            marcarConflicto(r.neighbour);
+        }
+    }
+    costes_[trans] += delta;
+    marcarConflicto(trans);
+
+    especimen_->aplicarMovimiento(trans, destino, delta);
+    if (especimen_->getBudget())
+        especimen_->getBudget()->contarParcial(2 * (adjacency_->offsets[trans+1] - adjacency_->offsets[trans]));
+}
+
+
+/**
+ * @brief Change of the interference of the individual for every frequency a transistor can take
+ *
+ * Nothing is charged to the budget, as in Especimen::deltasMovimiento.
+ * @param [in]	trans			transistor
+ * @param [out]	deltas			change of the interference for each index of the domain of trans, 0 for the current one
+ * @param [out]	comprobaciones	if not null, the restrictions checked are added to it
+ */
+
+void ConflictSet::deltas(unsigned trans, std::vector<int>& deltas, uint64_t* comprobaciones) const
+{
+    especimen_->deltasMovimiento(trans, deltas, comprobaciones);
+}
+
+
+/**
+ * @brief Number of transistors that add some interference with their current frequency
+ *
+ * @return size of the set
+ */
+
+unsigned ConflictSet::numConflictivos() const
+{
+    return conflictivos_.size();
+}
+
+
+/**
+ * @brief Transistor of the set, in no particular order
+ *
+ * @param [in]	posicion	position in the set, lower than numConflictivos
+ * @return transistor
+ */
+
+unsigned ConflictSet::conflictivo(unsigned posicion) const
+{
+    return conflictivos_[posicion];
+}
+
+
+/**
+ * @brief Adds a transistor to the set, or removes it, after its cost changed
+ *
+ * @param [in]	trans	transistor
+ */
+
+void ConflictSet::marcarConflicto(unsigned trans)
+{
+    bool conflicto = costes_[trans] > 0;
+    if (conflicto && posConflicto_[trans] < 0)
+    {
+        posConflicto_[trans] = conflictivos_.size();
+        conflictivos_.push_back(trans);
+    } else if (!conflicto && posConflicto_[trans] >= 0)
+    {
+        // El ultimo ocupa el hueco, el orden del conjunto no importa
+        unsigned ultimo = conflictivos_.back();
+        conflictivos_[posConflicto_[trans]] = ultimo;
+        posConflicto_[ultimo] = posConflicto_[trans];
+        conflictivos_.pop_back();
+        posConflicto_[trans] = -1;
+    }
+}
@@ -0,0 +1,46 @@
+/**
+ * @file ConflictSet.hpp
+ * @brief Headers declarations for class ConflictSet
+ *
+ */
+
+#ifndef CONFLICTSET_HPP
+#define CONFLICTSET_HPP
+
+#include <vector>
+
+#include "Especimen.hpp"
+
+/**
+ * @brief Transistors of an individual that add some interference with their current frequency
+ *
+ * A lighter alternative to CostTable for the searches that only move conflicting transistors:
+ * only the cost of the current frequency of each transistor is kept, so building it is one
+ * pass over the restrictions and a move only checks the restrictions of the moved transistor.
+ * The deltas of the other frequencies are computed on demand with Especimen::deltasMovimiento.
+ */
+
+class ConflictSet {
+public:
+    ConflictSet(DomainTable* domains, Adjacency* adjacency, Especimen* especimen);
+
+    void reconstruir();
+    void mover(unsigned trans, int destino);
+    void deltas(unsigned trans, std::vector<int>& deltas, uint64_t* comprobaciones = nullptr) const;
+
+    unsigned numConflictivos() const;
+    unsigned conflictivo(unsigned posicion) const;
+
+private:
+    void marcarConflicto(unsigned trans);
+
+    DomainTable* domains_;				///< Frequencies available to each transistor
+    Adjacency* adjacency_;				///< Restrictions incident to each transistor
+    Especimen* especimen_;				///< Individual the set describes
+
+    std::vector<int> costes_;			///< Interference each transistor adds with its current frequency
+    std::vector<unsigned> conflictivos_;	///< Transistors whose cost is not 0
+    std::vector<int> posConflicto_;		///< Position of each transistor in conflictivos_, -1 if it is not there
+};
+
+#endif /* CONFLICTSET_HPP */
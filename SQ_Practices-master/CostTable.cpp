@@ -0,0 +1,269 @@
+/**
+ * @file CostTable.cpp
+ * @brief Sources for the class CostTable
+ *
+ */
+
+#include "CostTable.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+
+/**
+ * @brief Default constructor
+ *
+ * Builds the table of the current genes of the individual
+ *
+ * @param [in]	domains		Frequencies available to each transistor
+ * @param [in]	adjacency	Restrictions incident to each transistor
+ * @param [in]	especimen	Individual the table describes, it must outlive the table
+ */
+
+CostTable::CostTable(DomainTable* domains, Adjacency* adjacency, Especimen* especimen) :
+        domains_(domains), adjacency_(adjacency), especimen_(especimen)
+{
+    unsigned numTrans = domains_->numTransistors();
+    filas_.resize(numTrans + 1);
+    filas_[0] = 0;
+    for (unsigned t = 0; t < numTrans; ++t)
+        filas_[t+1] = filas_[t] + domains_->size(t);
+    costes_.resize(filas_[numTrans]);
+    mejor_.resize(numTrans);
+    mejorDelta_.resize(numTrans);
+
+    hojas_ = 1;
+    while (hojas_ < numTrans)
+        hojas_ <<= 1;
+    arbol_.assign(2 * hojas_, numTrans);
+
+    reconstruir();
+}
+
+
+/**
+ * @brief Computes the whole table again from the genes of the individual
+ *
+ * Needed after the individual is changed by anything else than mover. The cost of a
+ * transistor can never be larger than the sum of its restrictions, so checking that sum
+ * once keeps every entry of the table safe from overflow.
+ */
+
+void CostTable::reconstruir()
+{
+    unsigned numTrans = domains_->numTransistors();
+    uint64_t comprobaciones = 0;
+    for (unsigned t = 0; t < numTrans; ++t)
+    {
+        int* fila = costes_.data() + filas_[t];
+        const int* dominio = domains_->domain(t);
+        int rango = domains_->size(t);
+        std::fill(fila, fila + rango, 0);
+
+        int64_t maximo = 0;
+        for (unsigned k = adjacency_->offsets[t]; k < adjacency_->offsets[t+1]; ++k)
+        {
+            const AdjRestriction& r = adjacency_->entries[k];
+            maximo += r.interference;
+            int vecino = especimen_->getFrecuencia(r.neighbour);
+            for (int i = 0; i < rango; ++i)
+                if( r.bound < std::abs(dominio[i] - vecino) )
+                    fila[i] += r.interference;
+        }
+        if (maximo > INT_MAX)
+            throw std::overflow_error("Integer Overflow");
+        comprobaciones += (uint64_t)(adjacency_->offsets[t+1] - adjacency_->offsets[t]) * rango;
+
+        elegirMejor(t);
+        arbol_[hojas_ + t] = t;
+    }
+    for (unsigned pos = hojas_ - 1; pos > 0; --pos)
+        arbol_[pos] = antes(arbol_[2*pos], arbol_[2*pos+1]) ? arbol_[2*pos] : arbol_[2*pos+1];
+
+    if (especimen_->getBudget())
+        especimen_->getBudget()->contarParcial(comprobaciones);
+}
+
+
+/**
+ * @brief Moves a transistor of the individual to another frequency and updates the table
+ *
+ * @param [in]	trans	transistor
+ * @param [in]	destino	index in the domain of trans of the new frequency
+ */
+
+void CostTable::mover(unsigned trans, int destino)
+{
+    int actual = especimen_->getIndice(trans);
+    if (destino == actual)
+        return;
+
+    const int* dominio = domains_->domain(trans);
+    int viejo = dominio[actual];
+    int nuevo = dominio[destino];
+    especimen_->aplicarMovimiento(trans, destino, delta(trans, destino));
+
+    // La fila de trans sigue igual pero su frecuencia actual no, y subir solo admite un cambio cada vez
+    mejorDelta_[trans] = coste(trans, mejor_[trans]) - coste(trans, destino);
+    subir(trans);
+
+    // Solo cambian las filas de los vecinos
+    uint64_t comprobaciones = 0;
+    for (unsigned k = adjacency_->offsets[trans]; k < adjacency_->offsets[trans+1]; ++k)
+    {
+        const AdjRestriction& r = adjacency_->entries[k];
+        int* fila = costes_.data() + filas_[r.neighbour];
+        const int* dominioVecino = domains_->domain(r.neighbour);
+        int rango = domains_->size(r.neighbour);
+        for (int i = 0; i < rango; ++i)
+        {
+            if( r.bound < std::abs(dominioVecino[i] - viejo) )
+                fila[i] -= r.interference;
+            if( r.bound < std::abs(dominioVecino[i] - nuevo) )
+                fila[i] += r.interference;
+        }
+        comprobaciones += 2 * rango;
+
+        elegirMejor(r.neighbour);
+        subir(r.neighbour);
+    }
+
+    if (especimen_->getBudget())
+        especimen_->getBudget()->contarParcial(comprobaciones);
+}
+
+
+/**
+ * @brief Interference a transistor adds with a frequency, given the current genes of its neighbours
+ *
+ * @param [in]	trans	transistor
+ * @param [in]	indice	index in the domain of trans
+ * @return cost
+ */
+
+int CostTable::coste(unsigned trans, int indice) const
+{
+    return costes_[filas_[trans] + indice];
+}
+
+
+/**
+ * @brief Change of the interference of the individual if a transistor took another frequency
+ *
+ * @param [in]	trans	transistor
+ * @param [in]	indice	index in the domain of trans
+ * @return new interference minus the current one
+ */
+
+int CostTable::delta(unsigned trans, int indice) const
+{
+    return coste(trans, indice) - coste(trans, especimen_->getIndice(trans));
+}
+
+
+/**
+ * @brief Cheapest frequency of a transistor, the first one if several cost the same
+ *
+ * @param [in]	trans	transistor
+ * @return index in the domain of trans
+ */
+
+int CostTable::mejorIndice(unsigned trans) const
+{
+    return mejor_[trans];
+}
+
+
+/**
+ * @brief Change of the interference of the best move of a transistor
+ *
+ * @param [in]	trans	transistor
+ * @return delta of moving trans to mejorIndice, 0 if its frequency is already the cheapest
+ */
+
+int CostTable::mejorDelta(unsigned trans) const
+{
+    return mejorDelta_[trans];
+}
+
+
+/**
+ * @brief Best move of the whole individual
+ *
+ * @param [out]	trans	transistor to move, the lowest one if several moves are as good
+ * @param [out]	destino	index in the domain of trans of its new frequency
+ * @return delta of the move, a negative value if it improves the individual
+ */
+
+int CostTable::mejorMovimiento(unsigned& trans, int& destino) const
+{
+    trans = arbol_[1];
+    if (trans >= domains_->numTransistors())
+    {
+        destino = -1;
+        return 0;
+    }
+    destino = mejor_[trans];
+    return mejorDelta(trans);
+}
+
+
+/**
+ * @brief Looks for the cheapest frequency of the row of a transistor
+ *
+ * @param [in]	trans	transistor
+ */
+
+void CostTable::elegirMejor(unsigned trans)
+{
+    const int* fila = costes_.data() + filas_[trans];
+    int rango = filas_[trans+1] - filas_[trans];
+    int elegido = 0;
+    for (int i = 1; i < rango; ++i)
+        if (fila[i] < fila[elegido])
+            elegido = i;
+    mejor_[trans] = elegido;
+    mejorDelta_[trans] = fila[elegido] - fila[especimen_->getIndice(trans)];
+}
+
+
+/**
+ * @brief Replays the matches of the tournament tree from the leaf of a transistor to the root
+ *
+ * The rest of the tree must be up to date. Once a match is won by the same transistor as
+ * before, and it is not trans, nothing above it changes.
+ * @param [in]	trans	transistor whose best move changed
+ */
+
+void CostTable::subir(unsigned trans)
+{
+    for (unsigned pos = (hojas_ + trans) >> 1; pos > 0; pos >>= 1)
+    {
+        unsigned ganador = antes(arbol_[2*pos], arbol_[2*pos+1]) ? arbol_[2*pos] : arbol_[2*pos+1];
+        if (ganador == arbol_[pos] && ganador != trans)
+            return;
+        arbol_[pos] = ganador;
+    }
+}
+
+
+/**
+ * @brief Compares the best moves of two transistors
+ *
+ * @param [in]	a	transistor, or the number of transistors for an empty leaf
+ * @param [in]	b	transistor, or the number of transistors for an empty leaf
+ * @return true if the move of a is better than the one of b, or as good and a is lower
+ */
+
+bool CostTable::antes(unsigned a, unsigned b) const
+{
+    unsigned numTrans = domains_->numTransistors();
+    if (a >= numTrans)
+        return false;
+    if (b >= numTrans)
+        return true;
+    int deltaA = mejorDelta_[a];
+    int deltaB = mejorDelta_[b];
+    return deltaA < deltaB || (deltaA == deltaB && a < b);
+}
@@ -0,0 +1,54 @@
+/**
+ * @file CostTable.hpp
+ * @brief Headers declarations for class CostTable
+ *
+ */
+
+#ifndef COSTTABLE_HPP
+#define COSTTABLE_HPP
+
+#include <vector>
+
+#include "Especimen.hpp"
+
+/**
+ * @brief Interference each transistor of an individual would add at each frequency of its domain
+ *
+ * The table is bound to one individual and kept up to date as long as every move goes
+ * through mover: moving a transistor only changes the rows of its neighbours. Each row
+ * keeps its best frequency and a tournament tree over the transistors keeps the best move
+ * of the whole individual, so both are read in O(1) and a move costs the size of the rows of
+ * its neighbours plus O(log n) per neighbour.
+ */
+
+class CostTable {
+public:
+    CostTable(DomainTable* domains, Adjacency* adjacency, Especimen* especimen);
+
+    void reconstruir();
+    void mover(unsigned trans, int destino);
+
+    int coste(unsigned trans, int indice) const;
+    int delta(unsigned trans, int indice) const;
+    int mejorIndice(unsigned trans) const;
+    int mejorDelta(unsigned trans) const;
+    int mejorMovimiento(unsigned& trans, int& destino) const;
+
+private:
+    void elegirMejor(unsigned trans);
+    void subir(unsigned trans);
+    bool antes(unsigned a, unsigned b) const;
+
+    DomainTable* domains_;				///< Frequencies available to each transistor
+    Adjacency* adjacency_;				///< Restrictions incident to each transistor
+    Especimen* especimen_;				///< Individual the table describes
+
+    std::vector<unsigned> filas_;		///< Position in costes_ of the row of each transistor (size T+1)
+    std::vector<int> costes_;			///< Cost of each frequency of each transistor, one row after another
+    std::vector<int> mejor_;			///< Index of the cheapest frequency of each transistor
+    std::vector<int> mejorDelta_;		///< Change of the interference of moving each transistor to mejor_
+    std::vector<unsigned> arbol_;		///< Tournament tree of transistors, the leaves from hojas_ on
+    unsigned hojas_;					///< Number of leaves, a power of two
+};
+
+#endif /* COSTTABLE_HPP */
@@ -5,28 +5,76 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
 ../AlgoritmosGeneticos.cpp \
+../Budget.cpp \
+../BusquedaTabu.cpp \
+../Checkpoint.cpp \
+../ConflictSet.cpp \
+../CostTable.cpp \
 ../Especimen.cpp \
+../FitnessCache.cpp \
+../InstanceCache.cpp \
+../InstanceGenerator.cpp \
+../InstanceReorder.cpp \
+../InstanceSplitter.cpp \
+../MappedFile.cpp \
 ../Parser.cpp \
 ../Poblacion.cpp \
+../ProgressReporter.cpp \
 ../Random.cpp \
+../RecocidoSimulado.cpp \
+../RestrictionStore.cpp \
+../ThreadPool.cpp \
+../Trace.cpp \
 ../Transistor.cpp \
 ../main.cpp 
 
 OBJS += \
 ./AlgoritmosGeneticos.o \
+./Budget.o \
+./BusquedaTabu.o \
+./Checkpoint.o \
+./ConflictSet.o \
+./CostTable.o \
 ./Especimen.o \
+./FitnessCache.o \
+./InstanceCache.o \
+./InstanceGenerator.o \
+./InstanceReorder.o \
+./InstanceSplitter.o \
+./MappedFile.o \
 ./Parser.o \
 ./Poblacion.o \
+./ProgressReporter.o \
 ./Random.o \
+./RecocidoSimulado.o \
+./RestrictionStore.o \
+./ThreadPool.o \
+./Trace.o \
 ./Transistor.o \
 ./main.o 
 
 CPP_DEPS += \
 ./AlgoritmosGeneticos.d \
+./Budget.d \
+./BusquedaTabu.d \
+./Checkpoint.d \
+./ConflictSet.d \
+./CostTable.d \
 ./Especimen.d \
+./FitnessCache.d \
+./InstanceCache.d \
+./InstanceGenerator.d \
+./InstanceReorder.d \
+./InstanceSplitter.d \
+./MappedFile.d \
 ./Parser.d \
 ./Poblacion.d \
+./ProgressReporter.d \
 ./Random.d \
+./RecocidoSimulado.d \
+./RestrictionStore.d \
+./ThreadPool.d \
+./Trace.d \
 ./Transistor.d \
 ./main.d 
 
@@ -0,0 +1,36 @@
+/**
+ * @file DomainTable.hpp
+ * @brief header files for DomainTable struct declaration
+ *
+ */
+
+#ifndef DOMAINTABLE_HPP
+#define DOMAINTABLE_HPP
+
+#include <vector>
+
+/**
+ * @brief Frequency domains stored in a single contiguous table
+ *
+ * The frequencies of every domain are laid out one after another in values. Each
+ * transistor keeps the position and size of its own domain, so reading the frequency
+ * at index i of transistor t is just values[transOffset[t] + i].
+ */
+
+struct DomainTable
+{
+    std::vector<int> values;				///< Frequencies of every domain, one domain after another
+    std::vector<unsigned> offsets;			///< Position in values of the first frequency of each domain
+    std::vector<unsigned> sizes;			///< Number of frequencies of each domain
+
+    std::vector<unsigned> transOffset;		///< Position in values of the domain of each transistor
+    std::vector<int> transSize;				///< Number of frequencies available to each transistor
+    std::vector<unsigned> transId;			///< Id of each transistor in var.txt
+
+    const int* domain(unsigned trans) const { return values.data() + transOffset[trans]; }
+    int size(unsigned trans) const { return transSize[trans]; }
+    unsigned numTransistors() const { return transOffset.size(); }
+};
+
+
+#endif /* DOMAINTABLE_HPP */
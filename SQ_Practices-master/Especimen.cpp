@@ -5,40 +5,317 @@
 */
 
 #include "Especimen.hpp"
-#include "sec_op.hpp"
+#include "OverflowPolicy.hpp"
+
+#include <algorithm>
+
+/**
+ * Fraction of the genes that may change between two evaluations and still be evaluated
+ * incrementally. Each change costs two scalar passes over the restrictions of its transistor
+ * while the full evaluation is vectorized, so the break-even point is at about 3% of
+ * the genes.
+ */
+static const double fraccionDelta = 0.025;
+
+
+/**
+ * @brief Zobrist key of a transistor taking a frequency
+ *
+ * The hash of an individual is the xor of the keys of all its genes, so changing one
+ * gene only needs two xors.
+ *
+ * @param [in]	trans	transistor
+ * @param [in]	freq	frequency of the transistor
+ * @return 64 bits key
+ */
+
+static inline uint64_t claveZobrist(unsigned trans, int freq)
+{
+    uint64_t z = ((uint64_t)trans << 32 | (uint32_t)freq) + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
 
 /**
  * @brief Main constructor
  *
  * Generates an "Especimen" starting the frequences with a greedy algorithm
  *
- * @param [in] 	transistors 		Transistor vector in which the population will be stored
+ * @param [in] 	domains 			Frequencies available to each transistor
  * @param [in]  restrictions		Restrictions of the population
- * @param [in]  indxTransRestr 		Index with the information of each transistor in the restriction group
+ * @param [in]  adjacency 			Restrictions incident to each transistor
+ * @param [in,out] rng 				Random number generator used to initialize the frequencies
+ * @param [in]  genes 				Row of a population genome where the genes are stored, 2 ints per transistor.
+ * 									If it is null the individual allocates its own storage
+ * @param [in]  budget 				Budget charged with the evaluations of the individual, null to not count them
  */
 
-Especimen::Especimen(std::vector<Transistor>* transistors, std::vector<Restriction>* restrictions,
-        std::vector<unsigned>* indxTransRestr) :
-                    transistors_(transistors), restrictions_(restrictions), 
-                    indxTransRestr_(indxTransRestr)
+Especimen::Especimen(DomainTable* domains, RestrictionStore* restrictions,
+        Adjacency* adjacency, RandomGenerator& rng, int* genes,
+        Budget* budget) :
+                    domains_(domains), restrictions_(restrictions), size_(domains->numTransistors()),
+                    adjacency_(adjacency), budget_(budget)
 {
-    randInit();
+    cambiosPerdidos_ = false;
+    enlazar(genes);
+    randInit(rng);
     evaluate();
 }
 
 
+/**
+ * @brief Constructor from a checkpoint
+ *
+ * Restores an individual written by guardarEstado, with no evaluation
+ *
+ * @param [in] 	domains 			Frequencies available to each transistor
+ * @param [in]  restrictions		Restrictions of the population
+ * @param [in]  adjacency 			Restrictions incident to each transistor
+ * @param [in,out] estado 			Checkpoint being read
+ * @param [in]  genes 				Row of a population genome where the genes are stored, 2 ints per transistor.
+ * 									If it is null the individual allocates its own storage
+ * @param [in]  budget 				Budget charged with the evaluations of the individual, null to not count them
+ */
+
+Especimen::Especimen(DomainTable* domains, RestrictionStore* restrictions,
+        Adjacency* adjacency, BinaryReader& estado, int* genes,
+        Budget* budget) :
+                    domains_(domains), restrictions_(restrictions), size_(domains->numTransistors()),
+                    adjacency_(adjacency), budget_(budget)
+{
+    if (estado.valor<unsigned>() != size_)
+        throw std::runtime_error("The checkpoint is of another instance");
+    totalInterference_ = estado.valor<int>();
+    hash_ = estado.valor<uint64_t>();
+    cambiosPerdidos_ = estado.valor<bool>();
+    cambios_.resize(estado.valor<uint64_t>());
+    estado.tabla(cambios_.data(), cambios_.size());
+    enlazar(genes);
+    estado.tabla(freqs_, 2*size_);
+}
+
+
 /**
  * @brief Copy constructor
  *
- * Generates a copy of the "Especimen"
+ * Generates a copy of the "Especimen" with its own storage, independent of any population
  * @param [in] 	orig	instance of the class Especimen
  */
 
 Especimen::Especimen(const Especimen& orig) :
-                    transistors_(orig.transistors_), restrictions_(orig.restrictions_),
-					freqs_(orig.freqs_), indexes_(orig.indexes_), indxTransRestr_(orig.indxTransRestr_),
+                    domains_(orig.domains_), restrictions_(orig.restrictions_), size_(orig.size_),
+                    adjacency_(orig.adjacency_), budget_(orig.budget_),
+                    totalInterference_(orig.totalInterference_)
+{
+    hash_ = orig.hash_;
+    cambios_ = orig.cambios_;
+    cambiosPerdidos_ = orig.cambiosPerdidos_;
+    enlazar(nullptr);
+    std::copy(orig.freqs_, orig.freqs_ + 2*size_, freqs_);
+}
+
+
+/**
+ * @brief Copy constructor into a row of a population genome
+ *
+ * @param [in] 	orig	instance of the class Especimen
+ * @param [in] 	genes	row of the population genome where the copy is stored, 2 ints per transistor
+ */
+
+Especimen::Especimen(const Especimen& orig, int* genes) :
+                    domains_(orig.domains_), restrictions_(orig.restrictions_), size_(orig.size_),
+                    adjacency_(orig.adjacency_), budget_(orig.budget_),
                     totalInterference_(orig.totalInterference_)
 {
+    hash_ = orig.hash_;
+    cambios_ = orig.cambios_;
+    cambiosPerdidos_ = orig.cambiosPerdidos_;
+    enlazar(genes);
+    std::copy(orig.freqs_, orig.freqs_ + 2*size_, freqs_);
+}
+
+
+/**
+ * @brief Move constructor
+ *
+ * Keeps the storage of orig, so an individual that lives in a population genome keeps
+ * pointing to its row when the vector of individuals grows
+ * @param [in,out] 	orig	instance of the class Especimen
+ */
+
+Especimen::Especimen(Especimen&& orig) noexcept :
+                    domains_(orig.domains_), restrictions_(orig.restrictions_),
+                    freqs_(orig.freqs_), indexes_(orig.indexes_), size_(orig.size_),
+                    propio_(std::move(orig.propio_)), hash_(orig.hash_),
+                    cambios_(std::move(orig.cambios_)), cambiosPerdidos_(orig.cambiosPerdidos_),
+                    adjacency_(orig.adjacency_), budget_(orig.budget_),
+                    totalInterference_(orig.totalInterference_)
+{
+    orig.freqs_ = orig.indexes_ = nullptr;
+    orig.size_ = 0;
+}
+
+
+/**
+ * @brief Assignment operator
+ *
+ * Copies the genes of otro into the storage of this individual, which does not change,
+ * so assigning to a member of a population writes in its row of the genome. The budget
+ * does not change either, so the evaluations are still charged to its population
+ * @param [in] 	otro	instance of the class Especimen
+ * @return this individual
+ */
+
+Especimen& Especimen::operator=(const Especimen& otro)
+{
+    if (this == &otro)
+        return *this;
+    
+    if (size_ != otro.size_)
+    {
+        if (!propio_.empty() || !freqs_)
+        {
+            size_ = otro.size_;
+            enlazar(nullptr);
+        } else
+            throw std::length_error("Individuals of different size");
+    }
+    
+    domains_ = otro.domains_;
+    restrictions_ = otro.restrictions_;
+    adjacency_ = otro.adjacency_;
+    totalInterference_ = otro.totalInterference_;
+    hash_ = otro.hash_;
+    cambios_ = otro.cambios_;
+    cambiosPerdidos_ = otro.cambiosPerdidos_;
+    std::copy(otro.freqs_, otro.freqs_ + 2*size_, freqs_);
+    return *this;
+}
+
+
+/**
+ * @brief Points the individual to its storage
+ *
+ * @param [in] 	genes	row of a population genome, 2 ints per transistor. If it is null
+ * 						the individual allocates its own storage
+ */
+
+void Especimen::enlazar(int* genes)
+{
+    if (!genes)
+    {
+        propio_.resize(2*size_);
+        genes = propio_.data();
+    } else
+        propio_.clear();
+    
+    freqs_ = genes;
+    indexes_ = genes + size_;
+}
+
+
+/**
+ * @brief Changes the frequency of a transistor, keeping the hash up to date
+ *
+ * @param [in] 	trans	transistor whose frequency changes
+ * @param [in] 	indice	position of the new frequency in the domain of the transistor
+ */
+
+void Especimen::setGen(unsigned trans, int indice)
+{
+    anotarCambio(trans);
+    hash_ ^= claveZobrist(trans, freqs_[trans]);
+    indexes_[trans] = indice;
+    freqs_[trans] = domains_->domain(trans)[indice];
+    hash_ ^= claveZobrist(trans, freqs_[trans]);
+}
+
+
+/**
+ * @brief Calculates the hash of the individual from all its genes
+ *
+ */
+
+void Especimen::calcHash()
+{
+    hash_ = 0;
+    for (unsigned i = 0; i < size_; ++i)
+        hash_ ^= claveZobrist(i, freqs_[i]);
+}
+
+
+/**
+ * @brief Moves the genes of the individual to a new row of a population genome
+ *
+ * @param [in] 	genes	new row, 2 ints per transistor. It must not overlap the current storage
+ */
+
+void Especimen::reubicar(int* genes)
+{
+    std::copy(freqs_, freqs_ + 2*size_, genes);
+    propio_.clear();
+    propio_.shrink_to_fit();
+    freqs_ = genes;
+    indexes_ = genes + size_;
+}
+
+
+/**
+ * @brief Writes the complete state of the individual to a checkpoint
+ *
+ * Besides the genes it keeps the changes pending of evaluation, so the next delta
+ * evaluation after a restart checks the same restrictions.
+ * @param [in,out] 	estado	checkpoint being written
+ */
+
+void Especimen::guardarEstado(BinaryWriter& estado) const
+{
+    estado.valor(size_);
+    estado.valor(totalInterference_);
+    estado.valor(hash_);
+    estado.valor(cambiosPerdidos_);
+    estado.valor((uint64_t)cambios_.size());
+    estado.tabla(cambios_.data(), cambios_.size());
+    estado.tabla(freqs_, 2*size_);
+}
+
+
+/**
+ * @brief Changes the budget charged with the evaluations of the individual
+ *
+ * @param [in] 	budget	new budget, null to stop counting
+ */
+
+void Especimen::setBudget(Budget* budget)
+{
+    budget_ = budget;
+}
+
+
+/**
+ * @brief Getter of the budget charged with the evaluations of the individual
+ *
+ * @return budget, null if they are not counted
+ */
+
+Budget* Especimen::getBudget() const
+{
+    return budget_;
+}
+
+
+/**
+ * @brief Number of restrictions of a transistor
+ *
+ * @param [in] 	trans	transistor
+ * @return restrictions incident to trans
+ */
+
+unsigned Especimen::grado(unsigned trans) const
+{
+    return adjacency_->offsets[trans+1] - adjacency_->offsets[trans];
 }
 
 
@@ -49,35 +326,92 @@ Especimen::Especimen(const Especimen& orig) :
 
 int Especimen::evaluate()
 {
-    totalInterference_ = 0;
-    for (unsigned i = 0; i < restrictions_->size(); ++i)
-        if ( (*restrictions_)[i].bound < 
-                std::abs(freqs_[ (*restrictions_)[i].trans1] - freqs_[ (*restrictions_)[i].trans2]) )
-            totalInterference_ = sec_sum(totalInterference_,(*restrictions_)[i].interference);
+    typedef DefaultOverflowPolicy Overflow;
+    totalInterference_ = Overflow::result(evaluateRestrictions(*restrictions_, freqs_));
+    cambios_.clear();
+    cambiosPerdidos_ = false;
+    if (budget_)
+        budget_->contarCompleta();
+    return totalInterference_;
+}
+
+
+/**
+ * @brief Updates the interference of the individual from the genes changed since its last evaluation
+ *
+ * The changes are undone back to the evaluated state and then made again one by one, adding
+ * for each one the difference in the cost of the restrictions of its transistor. When too many
+ * genes have changed it falls back to a full evaluation.
+ * @return The total interference
+ */
+int Especimen::evaluateDelta()
+{
+    if (cambiosPerdidos_)
+        return evaluate();
+    
+    // Volvemos al estado evaluado, guardando en cada cambio el valor que dejo
+    for (unsigned i = cambios_.size(); i-- > 0; )
+        std::swap(freqs_[ cambios_[i].trans ], cambios_[i].valor);
+    
+    // Repetimos los cambios acumulando la diferencia de coste de cada uno
+    typedef DefaultOverflowPolicy Overflow;
+    Overflow::Accumulator total = totalInterference_;
+    uint64_t comprobaciones = 0;
+    for (unsigned i = 0; i < cambios_.size(); ++i)
+    {
+        unsigned trans = cambios_[i].trans;
+        total = Overflow::sub(total, valueCost<Overflow>(trans, freqs_[trans]));
+        freqs_[trans] = cambios_[i].valor;
+        total = Overflow::add(total, valueCost<Overflow>(trans, freqs_[trans]));
+        comprobaciones += 2 * grado(trans);
+    }
+    if (budget_)
+        budget_->contarParcial(comprobaciones);
+    
+    totalInterference_ = Overflow::result(total);
+    cambios_.clear();
     return totalInterference_;
 }
 
 
+/**
+ * @brief Writes down a gene that is about to change, so the next evaluation can be incremental
+ *
+ * @param [in] 	trans	transistor whose frequency is going to change
+ */
+
+void Especimen::anotarCambio(unsigned trans)
+{
+    if (cambiosPerdidos_)
+        return;
+    
+    if (cambios_.size() >= fraccionDelta * size_)
+    {
+        cambiosPerdidos_ = true;
+        cambios_.clear();
+        return;
+    }
+    
+    cambios_.push_back( Cambio{trans, freqs_[trans]} );
+}
+
+
 /**
  * @brief Calculates the interference that would result as a change in a frequency
+ *
+ * The interference of the individual must be up to date, with no changes pending of evaluation.
+ * Like deltaMovimiento, nothing is charged to the budget.
  * @param [in] 	trans	transistor in which the frequency will change
  * @param [in]	pos 	position of the frequency
  */
 
-int Especimen::scanVal(unsigned trans, int pos)
+int Especimen::scanVal(unsigned trans, int pos) const
 {
-    int prevision = 0;
-    int rfreq = (*transistors_)[trans].getFreqRange();
-    prevision = sec_diff(totalInterference_,fullCalcCost(trans, indexes_[trans], 0, transistors_->size() ));
-    
-    indexes_[trans] = (indexes_[trans] + pos)%rfreq;
-    freqs_[trans] = (*transistors_)[trans][indexes_[trans]];
-    
-    prevision = sec_sum(prevision,fullCalcCost(trans, indexes_[trans], 0, transistors_->size() ));
-    
-    indexes_[trans] = (rfreq + (indexes_[trans] - pos)%rfreq) % rfreq;
-    freqs_[trans] = (*transistors_)[trans][indexes_[trans]];
-    return prevision;
+    int destino = indexes_[trans] + pos;
+    if (destino >= domains_->size(trans))
+        destino -= domains_->size(trans);
+    typedef DefaultOverflowPolicy Overflow;
+    return Overflow::result(Overflow::add(totalInterference_, deltaMovimiento(trans, destino)));
 }
 
 
@@ -88,27 +422,177 @@ int Especimen::scanVal(unsigned trans, int pos)
  */
 void Especimen::sigVal(unsigned trans, int pos)
 {
-    totalInterference_ = sec_diff(totalInterference_,fullCalcCost(trans, indexes_[trans], 0, transistors_->size()-1 ));
-    indexes_[trans] = (indexes_[trans] + pos)%(*transistors_)[trans].getFreqRange();
-    freqs_[trans] = (*transistors_)[trans][indexes_[trans]];
-    totalInterference_ = sec_sum(totalInterference_,fullCalcCost(trans, indexes_[trans], 0, transistors_->size()-1 ));
+    int destino = indexes_[trans] + pos;
+    if (destino >= domains_->size(trans))
+        destino -= domains_->size(trans);
+    uint64_t comprobaciones = 0;
+    aplicarMovimiento(trans, destino, deltaMovimiento(trans, destino, &comprobaciones));
+    if (budget_)
+        budget_->contarParcial(comprobaciones);
+}
+
+
+/**
+ * @brief Calculates how the interference would change if a transistor took another frequency
+ *
+ * Nothing is written, not even the budget, so several threads can ask at once about the same
+ * individual; the caller charges the restrictions checked to the budget it uses.
+ * Each restriction of the transistor is checked once, with the current and the new value.
+ * @param [in] 	trans			transistor
+ * @param [in]	destino			index in the domain of trans of the new frequency
+ * @param [out]	comprobaciones	if not null, the restrictions checked are added to it
+ * @return new interference minus the current one
+ */
+
+int Especimen::deltaMovimiento(unsigned trans, int destino, uint64_t* comprobaciones) const
+{
+    if (comprobaciones)
+        *comprobaciones += 2 * grado(trans);
+    return calcularDelta<DefaultOverflowPolicy>(trans, destino);
+}
+
+
+/**
+ * @brief Kernel of deltaMovimiento
+ *
+ * @tparam Overflow	policy that accumulates the interference and detects an overflow
+ * @param [in] 	trans	transistor
+ * @param [in]	destino	index in the domain of trans of the new frequency
+ * @return new interference minus the current one
+ */
+
+template <class Overflow>
+int Especimen::calcularDelta(unsigned trans, int destino) const
+{
+    int actual = freqs_[trans];
+    int nuevo = domains_->domain(trans)[destino];
+    typename Overflow::Accumulator delta = 0;
+    for (unsigned k = adjacency_->offsets[trans]; k < adjacency_->offsets[trans+1]; ++k)
+    {
+        const AdjRestriction& r = adjacency_->entries[k];
+        int vecino = freqs_[r.neighbour];
+        if( r.bound < std::abs(nuevo - vecino) )
+            delta = Overflow::add(delta, r.interference);
+        if( r.bound < std::abs(actual - vecino) )
+            delta = Overflow::sub(delta, r.interference);
+    }
+    return Overflow::result(delta);
+}
+
+
+/**
+ * @brief Calculates how the interference would change for every frequency a transistor can take
+ *
+ * Cheaper than asking deltaMovimiento for each frequency: every restriction is read once.
+ * Like deltaMovimiento, nothing is written and the caller charges the budget.
+ * @param [in] 	trans			transistor
+ * @param [out]	deltas			change of the interference for each index of the domain of trans, 0 for the current one
+ * @param [out]	comprobaciones	if not null, the restrictions checked are added to it
+ */
+
+void Especimen::deltasMovimiento(unsigned trans, std::vector<int>& deltas, uint64_t* comprobaciones) const
+{
+    typedef DefaultOverflowPolicy Overflow;
+    costesDominio<Overflow>(trans, [](unsigned) { return true; }, deltas);
+    if (comprobaciones)
+        *comprobaciones += (uint64_t)grado(trans) * deltas.size();
+    int actual = deltas[indexes_[trans]];
+    for (unsigned i = 0; i < deltas.size(); ++i)
+        deltas[i] = Overflow::result(Overflow::sub(deltas[i], actual));
+}
+
+
+/**
+ * @brief Moves a transistor to another frequency whose change of interference is already known
+ *
+ * @param [in] 	trans	transistor
+ * @param [in]	destino	index in the domain of trans of the new frequency
+ * @param [in]	delta	change of the interference given by deltaMovimiento or deltasMovimiento
+ */
+
+void Especimen::aplicarMovimiento(unsigned trans, int destino, int delta)
+{
+    // El delta no depende de la interferencia total, pero esta debe estar al dia antes de sumarlo
+    if (cambiosPerdidos_ || !cambios_.empty())
+        evaluateDelta();
+    
+    setGen(trans, destino);
+    typedef DefaultOverflowPolicy Overflow;
+    totalInterference_ = Overflow::result(Overflow::add(totalInterference_, delta));
+    cambios_.clear();
+}
+
+
+/**
+ * @brief Calculates the cost each frequency of a transistor would add, counting only some of its neighbours
+ *
+ * The loop goes over the restrictions and inside over the domain, so the frequency of each
+ * neighbour is read once. It checks grado(trans) restrictions for each frequency of the domain
+ * and charges nothing to the budget, its callers do.
+ * @tparam Overflow	policy that accumulates the costs and detects an overflow
+ * @param [in] 	trans		transistor
+ * @param [in]	colocado	tells whether the restrictions with a neighbour are counted
+ * @param [out]	costes		cost of each index of the domain of trans
+ */
+
+template <class Overflow, class Colocado>
+void Especimen::costesDominio(unsigned trans, Colocado colocado, std::vector<int>& costes) const
+{
+    static thread_local std::vector<typename Overflow::Accumulator> acumulados;
+    const int* dominio = domains_->domain(trans);
+    int rango = domains_->size(trans);
+    acumulados.assign(rango, 0);
+    for (unsigned k = adjacency_->offsets[trans]; k < adjacency_->offsets[trans+1]; ++k)
+    {
+        const AdjRestriction& r = adjacency_->entries[k];
+        if (!colocado(r.neighbour))
+            continue;
+        int vecino = freqs_[r.neighbour];
+        for (int i = 0; i < rango; ++i)
+            if( r.bound < std::abs(dominio[i] - vecino) )
+                acumulados[i] = Overflow::add(acumulados[i], r.interference);
+    }
+    costes.resize(rango);
+    for (int i = 0; i < rango; ++i)
+        costes[i] = Overflow::result(acumulados[i]);
+}
+
+
+/**
+ * @brief Chooses the first frequency of minimum cost
+ *
+ * @param [in]	costes	cost of each index of the domain of trans
+ * @return index of the frequency, -1 if the domain is empty
+ */
+
+int Especimen::frecuenciaMinima(const std::vector<int>& costes)
+{
+    int frecMin = -1;
+    int minimo = INT_MAX;
+    for (unsigned i = 0; i < costes.size(); ++i)
+        if (minimo > costes[i])
+        {
+            minimo = costes[i];
+            frecMin = i;
+        }
+    return frecMin;
 }
 
 
 /**
  *  @brief Random initializer algorithm
  *
+ * @param [in,out]	rng		random number generator
  */
 
-void Especimen::randInit()
+void Especimen::randInit(RandomGenerator& rng)
 {
-    indexes_.resize(transistors_->size());
-    freqs_.resize(transistors_->size());
-    for (unsigned i = 0; i < transistors_->size(); ++i)
+    for (unsigned i = 0; i < domains_->numTransistors(); ++i)
     {
-        indexes_[i] = (*transistors_)[i].getRandFrec();
-        freqs_[i] = (*transistors_)[i][indexes_[i]];
+        indexes_[i] = rng.getInt(0, domains_->size(i)-1);
+        freqs_[i] = domains_->domain(i)[indexes_[i]];
     }
+    calcHash();
 
 }
 
@@ -116,28 +600,28 @@ void Especimen::randInit()
 /**
  * @brief Greedy initializer algorithm
  *
+ * @param [in,out]	rng		random number generator
  */
-void Especimen::greedInit()
+void Especimen::greedInit(RandomGenerator& rng)
 {
     int k = 0;
-    int limit = getRandomInt(transistors_->size()/3, transistors_->size()-1);
-    indexes_.resize(transistors_->size());
-    freqs_.resize(transistors_->size());
-    for(int i = transistors_->size()-1; i >= 0; --i )
+    int limit = rng.getInt(domains_->numTransistors()/3, domains_->numTransistors()-1);
+    for(int i = domains_->numTransistors()-1; i >= 0; --i )
     {
         if(k < limit)
         {
-            indexes_[i] = (*transistors_)[i].getRandFrec();
-            freqs_[i] = (*transistors_)[i][indexes_[i]];
+            indexes_[i] = rng.getInt(0, domains_->size(i)-1);
+            freqs_[i] = domains_->domain(i)[indexes_[i]];
         }
         else
         {
             indexes_[i] = bestFreq(i);
-            freqs_[i] = (*transistors_)[i][indexes_[i]];
+            freqs_[i] = domains_->domain(i)[indexes_[i]];
         }
             
         ++k;
     }
+    calcHash();
     
 }
 
@@ -145,27 +629,27 @@ void Especimen::greedInit()
 /**
  * @brief Improved version of the greedy initializer algorithm
  *
+ * @param [in,out]	rng		random number generator
  */
 
-void Especimen::fullGreedInit() 
+void Especimen::fullGreedInit(RandomGenerator& rng) 
 {
-    int start = getRandomInt(0, transistors_->size()-1);
-    indexes_.resize(transistors_->size());
-    freqs_.resize(transistors_->size());
+    int start = rng.getInt(0, domains_->numTransistors()-1);
     
-    indexes_[start] = (*transistors_)[start].getRandFrec();
-    freqs_[start] = (*transistors_)[start][indexes_[start]];
+    indexes_[start] = rng.getInt(0, domains_->size(start)-1);
+    freqs_[start] = domains_->domain(start)[indexes_[start]];
     
-    int cabecera = (start + 1)%transistors_->size();
+    int cabecera = (start + 1)%domains_->numTransistors();
     int cola = start;
     
     while ( cabecera != cola )
     {
         indexes_[cabecera] = fullBestFreq(cabecera, cabecera, cola);
-        freqs_[cabecera] = (*transistors_)[cabecera][indexes_[cabecera]];
+        freqs_[cabecera] = domains_->domain(cabecera)[indexes_[cabecera]];
         
-        cabecera = (cabecera + 1)%transistors_->size();
+        cabecera = (cabecera + 1)%domains_->numTransistors();
     }
+    calcHash();
 }
 
 
@@ -180,141 +664,69 @@ void Especimen::fullGreedInit()
 
 int Especimen::fullBestFreq(unsigned trans, unsigned cabecera, unsigned cola)
 {
-    int minimo=INT_MAX;
-    int frecMin=-1;
-    int rango = (*transistors_)[trans].getFreqRange();
-    for(int i = 0; i < rango ; ++i)
-    {
-        int coste =fullCalcCost(trans,i, cabecera, cola);
-        if(minimo > coste)
-        {
-            minimo = coste;
-            frecMin=i;
-        }
-        if(!minimo)
-            break;
-    }
-    return frecMin;
+    static thread_local std::vector<int> costes;
+    costesDominio<DefaultOverflowPolicy>(trans, [cabecera, cola](unsigned vecino) {
+        return cola < cabecera ? (vecino >= cola && vecino < cabecera)
+                               : (vecino >= cola || vecino < cabecera);
+    }, costes);
+    if (budget_)
+        budget_->contarParcial((uint64_t)grado(trans) * costes.size());
+    return frecuenciaMinima(costes);
 }
 
 
 /**
- * @brief Calculates the cost that a transistor adds to the total
+ * @brief Calculates the cost that a transistor adds to the total taking into account all its restrictions
  *
- * @param [in]	trans		current transistor index
- * @param [in]	freq 		current frequency index
- * @param [in]	cabecera	beginning of the data structure in which the frequencies are stored
- * @param [in]	cola 		end of the data structure in which the frequencies are stored
+ * @param [in]	trans	current transistor index
+ * @param [in]	freq 	current frequency index
  * @return the cost the transistor adds
  */
-int Especimen::fullCalcCost(unsigned trans, int freq, unsigned cabecera, unsigned cola)
+int Especimen::transCost(unsigned trans, int freq)
 {
-    //    Calcula el coste de uno
-    int k = (*indxTransRestr_)[trans];
-    int cost = 0;
-    if ( trans+1 < (*indxTransRestr_).size())
-    {
-        if(cola < cabecera)
-        {
-            while (k != (int)(*indxTransRestr_)[trans+1])
-            {
-                if( (*restrictions_)[k].trans2 > cola &&  (*restrictions_)[k].trans2 < cabecera)
-                    if( (*restrictions_)[k].bound < std::abs((*transistors_)[trans][freq] -
-                        freqs_[(*restrictions_)[k].trans2]) )
-                    cost = sec_sum(cost,(*restrictions_)[k].interference);
-
-                ++k;
-            }  
-            
-            k = (*indxTransRestr_)[trans];
-            while(k >= 0 && k >= (int)cola)
-            {
-                if ((*restrictions_)[k].trans2 == trans)
-                    if( (*restrictions_)[k].bound < std::abs((*transistors_)[trans][freq] -
-                        freqs_[(*restrictions_)[k].trans1]) )
-                    cost = sec_sum(cost,(*restrictions_)[k].interference);
-                --k;
-            }
-        }
-        else
-        {
-            while (k != (int)(*indxTransRestr_)[trans+1])
-            {
-                if( !((*restrictions_)[k].trans2 > cola &&  (*restrictions_)[k].trans2 < cabecera) )
-                    if( (*restrictions_)[k].bound < std::abs((*transistors_)[trans][freq] -
-                        freqs_[(*restrictions_)[k].trans2]) )
-                    cost = sec_sum(cost,(*restrictions_)[k].interference);
-
-                ++k;
-            }
-            
-            k = (*indxTransRestr_)[trans];
-            while(k >= 0)
-            {
-                if ((*restrictions_)[k].trans2 == trans)
-                    if( (*restrictions_)[k].bound < std::abs((*transistors_)[trans][freq] -
-                        freqs_[(*restrictions_)[k].trans1]) )
-                    cost = sec_sum(cost,(*restrictions_)[k].interference);
-                --k;
-            }
-        }
-    }
-
-    return cost;
+    typedef DefaultOverflowPolicy Overflow;
+    return Overflow::result(valueCost<Overflow>(trans, domains_->domain(trans)[freq]));
 }
 
 
 /**
- * @brief Searches the best frequency taking into account the restrictions of the transistors placed
- * on his right in the data structure.
+ * @brief Calculates the cost of the restrictions of a transistor taking a given frequency value
  *
- * @param [in]	trans	current transistor index
- * @return the minimum frequency found
+ * @tparam Overflow	policy that accumulates the cost and detects an overflow
+ * @param [in]	trans	transistor
+ * @param [in]	valor	frequency value, not an index of its domain
+ * @return cost, still unchecked with the default policy
  */
-int Especimen::bestFreq(unsigned trans)
+
+template <class Overflow>
+typename Overflow::Accumulator Especimen::valueCost(unsigned trans, int valor) const
 {
-    int minimo=INT_MAX;
-    int frecMin=-1;
-    int rango = (*transistors_)[trans].getFreqRange();
-    for(int i = 0; i < rango ; ++i)
+    typename Overflow::Accumulator cost = 0;
+    for (unsigned k = adjacency_->offsets[trans]; k < adjacency_->offsets[trans+1]; ++k)
     {
-        int coste =calcCost(trans,i);
-        if(minimo > coste)
-        {
-            minimo = coste;
-            frecMin=i;
-        }
-        if(!minimo)
-            break;
+        const AdjRestriction& r = adjacency_->entries[k];
+        if( r.bound < std::abs(valor - freqs_[r.neighbour]) )
+            cost = Overflow::add(cost, r.interference);
     }
-    return frecMin;
+
+    return cost;
 }
 
 
 /**
- * @brief Calculates the individual cost of a transistor taking into account the restrictions related to the transistors placed
+ * @brief Searches the best frequency taking into account the restrictions of the transistors placed
  * on his right in the data structure.
  *
- * @param [in]	trans	 current transistor index
- * @param [in] 	freq	current frequency index
- * @return the cost of the transistor
+ * @param [in]	trans	current transistor index
+ * @return the minimum frequency found
  */
-int Especimen::calcCost(unsigned trans, int freq)
+int Especimen::bestFreq(unsigned trans)
 {
-    //    Calcula el coste de uno
-    unsigned k = (*indxTransRestr_)[trans];
-    int cost = 0;
-    if ( trans+1 < (*indxTransRestr_).size())
-    {
-        while (k != (*indxTransRestr_)[trans+1]) 
-        {
-            if( (*restrictions_)[k].bound < std::abs((*transistors_)[trans][freq] -
-                    freqs_[(*restrictions_)[k].trans2]) )
-            	cost = sec_sum(cost,(*restrictions_)[k].interference);
-            ++k;
-        }
-    }
-    return cost;
+    static thread_local std::vector<int> costes;
+    costesDominio<DefaultOverflowPolicy>(trans, [trans](unsigned vecino) { return vecino > trans; }, costes);
+    if (budget_)
+        budget_->contarParcial((uint64_t)grado(trans) * costes.size());
+    return frecuenciaMinima(costes);
 }
 
 
@@ -328,8 +740,11 @@ int Especimen::calcCost(unsigned trans, int freq)
 
 bool Especimen::operator==(const Especimen& otro) {
     
+    if(this->hash_!=otro.hash_)
+        return false;
+    
     if(this->totalInterference_==otro.totalInterference_){
-        for(unsigned i = 0; i< this->freqs_.size();++i)
+        for(unsigned i = 0; i< this->size_;++i)
             if(this->freqs_[i]!=otro.freqs_[i])
                 return false;
     }else
@@ -349,8 +764,11 @@ bool Especimen::operator==(const Especimen& otro) {
 
 bool Especimen::operator!=(const Especimen& otro)
 {
+    if(this->hash_!=otro.hash_)
+        return true;
+    
     if(this->totalInterference_==otro.totalInterference_){
-    for(unsigned i = 0; i< this->freqs_.size();++i)
+    for(unsigned i = 0; i< this->size_;++i)
         if(this->freqs_[i]!=otro.freqs_[i])
             return true;
     }else
@@ -376,7 +794,7 @@ bool Especimen::operator<(const Especimen& otro) const{
     if(totalInterference_ > otro.totalInterference_)
         return false;
     
-    if (freqs_ < otro.freqs_)
+    if (std::lexicographical_compare(freqs_, freqs_ + size_, otro.freqs_, otro.freqs_ + otro.size_))
         return true;
     
     return false;
@@ -394,6 +812,31 @@ int Especimen::getInterference() const
 }
 
 
+/**
+ * @brief Setter of the totalInterference attribute, for individuals whose interference is already known
+ *
+ * @param [in]	interferencia	the total interference
+ */
+void Especimen::setInterference(int interferencia)
+{
+    totalInterference_ = interferencia;
+    cambios_.clear();
+    cambiosPerdidos_ = false;
+}
+
+
+/**
+ * @brief Getter of the hash of the frequencies
+ *
+ * Two individuals with the same frequencies always have the same hash
+ * @return the Zobrist hash
+ */
+uint64_t Especimen::getHash() const
+{
+    return hash_;
+}
+
+
 /**
  * @brief Destroyer
  *
@@ -410,19 +853,25 @@ Especimen::~Especimen()
  *
  * @param [in,out]	padreA		first vector that will be used for the cross
  * @param [in,out]	padreB		second vector that will be used for the cross
+ * @param [in,out]	rng			random number generator
  * @param [in]		minimo		first point of the cross
  * @param [in]		maximo		second point of the cross
  */
 
-void cruce2Puntos(Especimen &padreA, Especimen &padreB,int minimo,int maximo){
+void cruce2Puntos(Especimen &padreA, Especimen &padreB,RandomGenerator& rng,int minimo,int maximo){
     if(maximo<=0)
-        maximo=padreA.freqs_.size()/3;
-    int puntoA=getRandomInt(0,padreA.freqs_.size()-1);  	//posicion de inicio para los intercambios
-    int volumen=getRandomInt(minimo,maximo);                //numero de elementos a intercambiar
+        maximo=padreA.size_/3;
+    int puntoA=rng.getInt(0,padreA.size_-1);  	//posicion de inicio para los intercambios
+    int volumen=rng.getInt(minimo,maximo);                //numero de elementos a intercambiar
     
-    int fAux,iAux,pos;
-    for(int i = 0; i < volumen; i++){
-        pos=(puntoA+i) % padreA.freqs_.size();
+    int fAux,iAux;
+    int tam=padreA.size_;
+    int pos=puntoA;
+    for(int i = 0; i < volumen; i++, pos++){
+        if(pos >= tam)
+            pos=0;
+        padreA.anotarCambio(pos);
+        padreB.anotarCambio(pos);
         fAux=padreA.freqs_[pos];
         iAux=padreA.indexes_[pos];
         
@@ -431,6 +880,10 @@ void cruce2Puntos(Especimen &padreA, Especimen &padreB,int minimo,int maximo){
         
         padreB.freqs_[pos]=fAux;
         padreB.indexes_[pos]=iAux;
+        
+        uint64_t cambio=claveZobrist(pos,fAux)^claveZobrist(pos,padreA.freqs_[pos]);
+        padreA.hash_^=cambio;
+        padreB.hash_^=cambio;
     }
 }
 
@@ -441,12 +894,13 @@ void cruce2Puntos(Especimen &padreA, Especimen &padreB,int minimo,int maximo){
  *
  * @param [in,out]	padreA		first vector that will be used for the cross
  * @param [in,out]	padreB		second vector that will be used for the cross
+ * @param [in,out]	rng			random number generator
  * @param [in] 		alpha		percentage of randomness, 0.5 is the standard
  */
 
-void cruceBlx(Especimen &padreA, Especimen &padreB,float alpha){
+void cruceBlx(Especimen &padreA, Especimen &padreB,RandomGenerator& rng,float alpha){
     
-    for (unsigned transistor = 0; transistor < padreA.freqs_.size(); ++transistor)
+    for (unsigned transistor = 0; transistor < padreA.size_; ++transistor)
     {
         int max,min;
         
@@ -457,15 +911,13 @@ void cruceBlx(Especimen &padreA, Especimen &padreB,float alpha){
         min=std::min<int>( padreA.indexes_[transistor], padreB.indexes_[transistor]);
         max += intervalo;
         min -= intervalo;
-        max=std::min<int>(max, padreA.indexes_.size()-1);
+        max=std::min<int>(max, padreA.domains_->size(transistor)-1);
         min=std::max<int>(min,0);
         if(intervalo > 0)
         {
            
-                padreA.indexes_[transistor]=getRandomInt(min,max);
-                padreB.indexes_[transistor]=getRandomInt(min,max);
-                padreA.freqs_[transistor]=(*padreA.transistors_) [transistor][padreA.indexes_[transistor]];
-                padreB.freqs_[transistor]=(*padreB.transistors_) [transistor][padreB.indexes_[transistor]];
+                padreA.setGen(transistor,rng.getInt(min,max));
+                padreB.setGen(transistor,rng.getInt(min,max));
         }
 
 
@@ -478,27 +930,26 @@ void cruceBlx(Especimen &padreA, Especimen &padreB,float alpha){
  * @brief Mutates the frequencies of an individual randomly
  *
  * @param	[in,out] individuo			individual that will be muted
+ * @param	[in,out] rng				random number generator
  * @param	[in] 	 probabilidad		mutation probablility, the standard is 0.1
  */
 
-void mutar(Especimen &individuo, double probabilidad){
+void mutar(Especimen &individuo, RandomGenerator& rng, double probabilidad){
     
     // Calculamos esperanza matematica
-    int espMat = (int)(individuo.freqs_.size()-1)*probabilidad;
+    int espMat = (int)(individuo.size_-1)*probabilidad;
     
     // Si la esperanza matematica es 0, se opta por el metodo tradicional
     if (espMat == 0)
-        for(unsigned i=0; i< individuo.freqs_.size();++i){
-            if( (double)( rand() / RAND_MAX) <= probabilidad){
-                individuo.indexes_[i] = getRandomInt(0,individuo.indexes_.size()-1);
-                individuo.freqs_[i] = (*individuo.transistors_) [i][individuo.indexes_[i]];
+        for(unsigned i=0; i< individuo.size_;++i){
+            if( rng.getDouble() < probabilidad){
+                individuo.setGen(i, rng.getInt(0,individuo.domains_->size(i)-1));
             }
         }
     else {
         for (int i = 0; i < espMat; ++i) {
-            int mutado = getRandomInt(0, individuo.freqs_.size()-1);
-            individuo.indexes_[mutado] = getRandomInt(0,individuo.indexes_.size()-1);
-            individuo.freqs_[mutado] = (*individuo.transistors_) [i][individuo.indexes_[i]];
+            int mutado = rng.getInt(0, individuo.size_-1);
+            individuo.setGen(mutado, rng.getInt(0,individuo.domains_->size(mutado)-1));
         }
     }
 }
@@ -513,7 +964,7 @@ void mutar(Especimen &individuo, double probabilidad){
 
 int Especimen::getFreqRange(int trans)
 {
-    return (*transistors_)[trans].getFreqRange();
+    return domains_->size(trans);
 }
 
 
@@ -523,8 +974,50 @@ int Especimen::getFreqRange(int trans)
  * @return	the size of said data structure
  */
 
-int Especimen::getSize()
+int Especimen::getSize() const
+{
+    return domains_->numTransistors();
+}
+
+
+/**
+ * @brief Getter of the frequency assigned to a transistor
+ *
+ * @param [in]	trans	transistor
+ * @return frequency value, not its index in the domain
+ */
+
+int Especimen::getFrecuencia(unsigned trans) const
+{
+    return freqs_[trans];
+}
+
+
+
+/**
+ * @brief Getter of the index in its domain of the frequency assigned to a transistor
+ *
+ * @param [in]	trans	transistor
+ * @return index of the frequency
+ */
+
+int Especimen::getIndice(unsigned trans) const
 {
-    return transistors_->size();
+    return indexes_[trans];
 }
 
+
+/**
+ * @brief Setter of the frequency of a transistor, given by its index in the domain
+ *
+ * The change is noted down like the ones of the crossovers, so the next evaluateDelta
+ * updates the interference.
+ * @param [in]	trans	transistor
+ * @param [in]	indice	index of the frequency in the domain of trans
+ */
+
+void Especimen::setIndice(unsigned trans, int indice)
+{
+    if (indexes_[trans] != indice)
+        setGen(trans, indice);
+}
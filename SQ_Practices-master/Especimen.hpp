@@ -7,9 +7,12 @@
 #ifndef ESPECIMEN_HPP
 #define ESPECIMEN_HPP
 
-#include "Restriction.hpp"
-#include "Transistor.hpp"
+#include "RestrictionStore.hpp"
+#include "Adjacency.hpp"
+#include "DomainTable.hpp"
 #include "Random.hpp"
+#include "Budget.hpp"
+#include "BinaryStream.hpp"
 #include <vector>
 #include <climits>
 
@@ -20,50 +23,109 @@
 
 class Especimen {
 public:
-    Especimen( std::vector<Transistor>* transistors, 
-            std::vector<Restriction>* restrictions,
-            std::vector<unsigned>* indxTransRestr );
+    Especimen( DomainTable* domains, 
+            RestrictionStore* restrictions,
+            Adjacency* adjacency,
+            RandomGenerator& rng,
+            int* genes = nullptr,
+            Budget* budget = nullptr );
+    Especimen( DomainTable* domains, 
+            RestrictionStore* restrictions,
+            Adjacency* adjacency,
+            BinaryReader& estado,
+            int* genes,
+            Budget* budget );
     Especimen(const Especimen& orig);
+    Especimen(const Especimen& orig, int* genes);
+    Especimen(Especimen&& orig) noexcept;
+    Especimen& operator= (const Especimen& otro);
     virtual ~Especimen();
     
-    int getSize();
+    void reubicar(int* genes);
+    void setBudget(Budget* budget);
+    Budget* getBudget() const;
+    void guardarEstado(BinaryWriter& estado) const;
+    
+    int getSize() const;
+    int getFrecuencia(unsigned trans) const;
+    int getIndice(unsigned trans) const;
+    void setIndice(unsigned trans, int indice);
     int getFreqRange(int trans);
     
     int evaluate();
+    int evaluateDelta();
     
-    int scanVal(unsigned trans, int pos);
+    int scanVal(unsigned trans, int pos) const;
     void sigVal(unsigned trans, int pos);
     
+    int deltaMovimiento(unsigned trans, int destino, uint64_t* comprobaciones = nullptr) const;
+    void deltasMovimiento(unsigned trans, std::vector<int>& deltas, uint64_t* comprobaciones = nullptr) const;
+    void aplicarMovimiento(unsigned trans, int destino, int delta);
+    
     bool operator== (const Especimen& otro);
     bool operator!= (const Especimen& otro);
     bool operator< (const Especimen& otro) const;
     
     int getInterference() const;
+    void setInterference(int interferencia);
+    uint64_t getHash() const;
     
-    friend void cruce2Puntos(Especimen &padreA, Especimen &padreB,int minimo = 1,int maximo = 0);
-    friend void cruceBlx(Especimen &padreA, Especimen &padreB,float alpha = 0.1);
-    friend void mutar(Especimen &individuo,double probabilidad = 0.1);
+    friend void cruce2Puntos(Especimen &padreA, Especimen &padreB,RandomGenerator& rng,int minimo,int maximo);
+    friend void cruceBlx(Especimen &padreA, Especimen &padreB,RandomGenerator& rng,float alpha);
+    friend void mutar(Especimen &individuo,RandomGenerator& rng,double probabilidad);
 private:
-    std::vector<Transistor>* transistors_;		///< Vector with the transistors of the individual
-    std::vector<Restriction>* restrictions_;	///< Vector with the restrictions that the individual will have to consider
+    /**
+     * @brief Gene changed since the last evaluation and the frequency it had before the change
+     */
+    struct Cambio
+    {
+        unsigned trans;							///< Transistor whose frequency changed
+        int valor;								///< Frequency of the transistor before the change
+    };
+    
+    DomainTable* domains_;						///< Frequencies available to each transistor of the individual
+    RestrictionStore* restrictions_;			///< Vector with the restrictions that the individual will have to consider
     
    
-    std::vector<int> freqs_;					///< Vector with the frequencies of the individual
-    std::vector<int> indexes_;					///< Index which represents the valid frequencies this individual will be able to take
-    std::vector<unsigned>* indxTransRestr_;		///< Indexes of the restrictions that we will have to be taken into account
+    int* freqs_;								///< Frequencies of the individual
+    int* indexes_;								///< Index which represents the valid frequencies this individual will be able to take
+    unsigned size_;								///< Number of genes of the individual
+    std::vector<int> propio_;					///< Storage of the genes when the individual does not live in a population genome
+    uint64_t hash_;								///< Zobrist hash of the frequencies, kept up to date on every gene change
+    std::vector<Cambio> cambios_;				///< Gene changes since the last evaluation, in the order they were made
+    bool cambiosPerdidos_;						///< Too many changes to keep track of them, a full evaluation is needed
+    Adjacency* adjacency_;						///< Restrictions incident to each transistor
+    Budget* budget_;							///< Budget charged with the evaluations of the individual, may be null
     
-    void greedInit();
-    void randInit();
-    void fullGreedInit();
+    void enlazar(int* genes);
+    void setGen(unsigned trans, int indice);
+    unsigned grado(unsigned trans) const;
+    void anotarCambio(unsigned trans);
+    void calcHash();
+    
+    void greedInit(RandomGenerator& rng);
+    void randInit(RandomGenerator& rng);
+    void fullGreedInit(RandomGenerator& rng);
     
     int bestFreq(unsigned trans);
-    int calcCost(unsigned trans, int freq);
+    int transCost(unsigned trans, int freq);
+    template <class Overflow>
+    typename Overflow::Accumulator valueCost(unsigned trans, int valor) const;
+    template <class Overflow>
+    int calcularDelta(unsigned trans, int destino) const;
     
     int fullBestFreq(unsigned trans, unsigned cabecera, unsigned cola);
-    int fullCalcCost(unsigned trans, int freq, unsigned cabecera, unsigned cola);
+    
+    template <class Overflow, class Colocado>
+    void costesDominio(unsigned trans, Colocado colocado, std::vector<int>& costes) const;
+    int frecuenciaMinima(const std::vector<int>& costes);
     
     int totalInterference_;						///< The sum of the interference obtained for this member of the population
 };
 
+void cruce2Puntos(Especimen &padreA, Especimen &padreB,RandomGenerator& rng,int minimo = 1,int maximo = 0);
+void cruceBlx(Especimen &padreA, Especimen &padreB,RandomGenerator& rng,float alpha = 0.1);
+void mutar(Especimen &individuo,RandomGenerator& rng,double probabilidad = 0.1);
+
 #endif /* ESPECIMEN_HPP */
 
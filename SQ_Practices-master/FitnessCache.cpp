@@ -0,0 +1,83 @@
+/**
+ * @file FitnessCache.cpp
+ * @brief Sources for the class FitnessCache
+ *
+ */
+
+#include "FitnessCache.hpp"
+
+/**
+ * @brief Default constructor
+ *
+ * @param [in]	entradas	number of slots, rounded up to a power of two
+ */
+
+FitnessCache::FitnessCache(unsigned entradas)
+{
+    unsigned tam = 1;
+    while (tam < entradas)
+        tam <<= 1;
+    entradas_.assign(tam, Entrada{0, 0, false});
+    mascara_ = tam - 1;
+}
+
+
+/**
+ * @brief Looks for the interference of an individual
+ *
+ * @param [in]	hash			hash of the individual
+ * @param [out]	interferencia	interference of the individual, only written when found
+ * @return true if the individual was in the cache
+ */
+
+bool FitnessCache::buscar(uint64_t hash, int& interferencia) const
+{
+    const Entrada& entrada = entradas_[hash & mascara_];
+    if (!entrada.ocupada || entrada.hash != hash)
+        return false;
+
+    interferencia = entrada.interferencia;
+    return true;
+}
+
+
+/**
+ * @brief Stores the interference of an individual, replacing whatever was in its slot
+ *
+ * @param [in]	hash			hash of the individual
+ * @param [in]	interferencia	interference of the individual
+ */
+
+void FitnessCache::guardar(uint64_t hash, int interferencia)
+{
+    entradas_[hash & mascara_] = Entrada{hash, interferencia, true};
+}
+
+
+/**
+ * @brief Writes the slots of the cache to a checkpoint
+ *
+ * @param [in,out]	estado	checkpoint being written
+ */
+
+void FitnessCache::guardarEstado(BinaryWriter& estado) const
+{
+    estado.valor((uint64_t)entradas_.size());
+    estado.tabla(entradas_.data(), entradas_.size());
+}
+
+
+/**
+ * @brief Restores the slots of the cache from a checkpoint
+ *
+ * @param [in,out]	estado	checkpoint being read
+ */
+
+void FitnessCache::cargarEstado(BinaryReader& estado)
+{
+    entradas_.resize(estado.valor<uint64_t>());
+    if (entradas_.empty() || (entradas_.size() & (entradas_.size() - 1)))
+        throw std::runtime_error("Wrong size of the cache in the checkpoint");
+    estado.tabla(entradas_.data(), entradas_.size());
+    mascara_ = entradas_.size() - 1;
+}
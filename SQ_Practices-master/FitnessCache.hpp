@@ -0,0 +1,47 @@
+/**
+ * @file FitnessCache.hpp
+ * @brief Headers declarations for class FitnessCache
+ *
+ */
+
+#ifndef FITNESSCACHE_HPP
+#define FITNESSCACHE_HPP
+
+#include <vector>
+#include <cstdint>
+
+#include "BinaryStream.hpp"
+
+/**
+ * @brief Bounded cache of the interference of already evaluated individuals
+ *
+ * Individuals are identified by their Zobrist hash. The cache is direct mapped: each
+ * hash has a single slot and a new entry simply overwrites the previous one, so the
+ * memory used never grows.
+ */
+
+class FitnessCache {
+public:
+    explicit FitnessCache(unsigned entradas = 4096);
+
+    bool buscar(uint64_t hash, int& interferencia) const;
+    void guardar(uint64_t hash, int interferencia);
+    void guardarEstado(BinaryWriter& estado) const;
+    void cargarEstado(BinaryReader& estado);
+
+private:
+    /**
+     * @brief Slot of the cache
+     */
+    struct Entrada
+    {
+        uint64_t hash;					///< Hash of the individual stored in the slot
+        int interferencia;				///< Interference of that individual
+        bool ocupada;					///< Whether the slot holds an individual
+    };
+
+    std::vector<Entrada> entradas_;		///< Slots of the cache, a power of two of them
+    uint64_t mascara_;					///< Number of slots minus one, to get the slot of a hash
+};
+
+#endif /* FITNESSCACHE_HPP */
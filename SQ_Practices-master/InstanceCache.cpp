@@ -0,0 +1,210 @@
+/**
+ * @file InstanceCache.cpp
+ * @brief Sources for the class InstanceCache
+ *
+ */
+
+#include "InstanceCache.hpp"
+
+#include "MappedFile.hpp"
+
+#include <cstring>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/stat.h>
+
+const uint32_t InstanceCache::version = 4;
+
+
+/**
+ * @brief Rounds a size up to a multiple of 8 bytes
+ */
+
+static inline uint64_t alinear(uint64_t bytes)
+{
+    return (bytes + 7) & ~(uint64_t)7;
+}
+
+
+/**
+ * @brief Copies the next table of a mapped file into a vector
+ *
+ * @param [in,out]	pos		position of the table in the file, moved to the next one
+ * @param [in]		n		number of elements of the table
+ * @param [out]		result	vector in which the table is copied
+ */
+
+template <typename T>
+static void leerTabla(const char*& pos, uint64_t n, std::vector<T>& result)
+{
+    const T* inicio = reinterpret_cast<const T*>(pos);
+    result.assign(inicio, inicio + n);
+    pos += alinear(n * sizeof(T));
+}
+
+
+/**
+ * @brief Writes a table at the end of a file, padded to a multiple of 8 bytes
+ *
+ * @param [in]	file	file being written
+ * @param [in]	table	table to write
+ * @return false if the table could not be written
+ */
+
+template <typename T>
+static bool escribirTabla(FILE* file, const std::vector<T>& table)
+{
+    static const char relleno[8] = {0};
+    uint64_t bytes = table.size() * sizeof(T);
+    if (bytes && fwrite(table.data(), 1, bytes, file) != bytes)
+        return false;
+    return fwrite(relleno, 1, alinear(bytes) - bytes, file) == alinear(bytes) - bytes;
+}
+
+
+/**
+ * @brief Gets the size and modification time of the text files of the instance
+ *
+ * @param [in]	sources		paths of dom.txt, var.txt and ctr.txt
+ * @param [out]	stamps		size and modification time in ns of each file
+ * @return false if any of the files can not be found
+ */
+
+bool InstanceCache::stamp(const std::vector<std::string>& sources, uint64_t stamps[3][2])
+{
+    if (sources.size() != 3)
+        return false;
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        struct stat info;
+        if (stat(sources[i].c_str(), &info) != 0)
+            return false;
+        stamps[i][0] = info.st_size;
+        stamps[i][1] = (uint64_t)info.st_mtim.tv_sec * 1000000000u + info.st_mtim.tv_nsec;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Reads the instance from its binary file, if it is up to date
+ *
+ * @param [in]		path			path of the binary file
+ * @param [in]		sources			paths of dom.txt, var.txt and ctr.txt the file was built from
+ * @param [in]		TNumber			limit of transistors used to parse the instance
+ * @param [out]		domains			frequencies available to each transistor
+ * @param [out]		restrictions	restrictions as a structure of arrays
+ * @param [out]		adjacency		restrictions incident to each transistor
+ * @return false if the file does not exist, is damaged or is out of date. Nothing is read then
+ */
+
+bool InstanceCache::load(const std::string& path, const std::vector<std::string>& sources, int TNumber,
+        DomainTable& domains, RestrictionStore& restrictions,
+        Adjacency& adjacency)
+{
+    uint64_t stamps[3][2];
+    if (!stamp(sources, stamps))
+        return false;
+
+    MappedFile file(path);
+    if (!file.good() || file.size() < sizeof(Header))
+        return false;
+    uint64_t tam = file.size();
+    const char* datos = file.data();
+
+    Header header;
+    std::memcpy(&header, datos, sizeof(Header));
+
+    const uint64_t* c = header.counts;
+    uint64_t esperado = alinear(sizeof(Header));
+    const uint64_t tamanos[12] = {
+            sizeof(int), sizeof(unsigned), sizeof(unsigned), sizeof(unsigned), sizeof(int),
+            sizeof(int32_t), sizeof(int32_t), sizeof(int32_t), sizeof(int32_t),
+            sizeof(unsigned), sizeof(AdjRestriction), sizeof(unsigned) };
+    for (unsigned i = 0; i < 12 && esperado <= tam; ++i)
+        esperado += c[i] > tam ? tam + 1 : alinear(c[i] * tamanos[i]);
+
+    bool valido = std::memcmp(header.magic, "SQINST", 7) == 0 && header.version == version
+            && header.TNumber == TNumber && std::memcmp(header.stamps, stamps, sizeof(stamps)) == 0
+            && esperado == tam;
+    if (valido)
+    {
+        const char* pos = datos + alinear(sizeof(Header));
+        leerTabla(pos, c[0], domains.values);
+        leerTabla(pos, c[1], domains.offsets);
+        leerTabla(pos, c[2], domains.sizes);
+        leerTabla(pos, c[3], domains.transOffset);
+        leerTabla(pos, c[4], domains.transSize);
+        leerTabla(pos, c[5], restrictions.trans1);
+        leerTabla(pos, c[6], restrictions.trans2);
+        leerTabla(pos, c[7], restrictions.bound);
+        leerTabla(pos, c[8], restrictions.interference);
+        leerTabla(pos, c[9], adjacency.offsets);
+        leerTabla(pos, c[10], adjacency.entries);
+        leerTabla(pos, c[11], domains.transId);
+    }
+
+    return valido;
+}
+
+
+/**
+ * @brief Writes the binary file of an instance
+ *
+ * The file is written under a temporary name and then renamed, so a process reading it at
+ * the same time never sees it half written.
+ *
+ * @param [in]	path			path of the binary file
+ * @param [in]	sources			paths of dom.txt, var.txt and ctr.txt the instance was parsed from
+ * @param [in]	TNumber			limit of transistors used to parse the instance
+ * @param [in]	domains			frequencies available to each transistor
+ * @param [in]	restrictions	restrictions as a structure of arrays
+ * @param [in]	adjacency		restrictions incident to each transistor
+ * @return false if the file could not be written
+ */
+
+bool InstanceCache::save(const std::string& path, const std::vector<std::string>& sources, int TNumber,
+        const DomainTable& domains, const RestrictionStore& restrictions,
+        const Adjacency& adjacency)
+{
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, "SQINST", 7);
+    header.version = version;
+    header.TNumber = TNumber;
+    if (!stamp(sources, header.stamps))
+        return false;
+
+    uint64_t* c = header.counts;
+    c[0] = domains.values.size();           c[1] = domains.offsets.size();
+    c[2] = domains.sizes.size();            c[3] = domains.transOffset.size();
+    c[4] = domains.transSize.size();        c[5] = restrictions.trans1.size();
+    c[6] = restrictions.trans2.size();      c[7] = restrictions.bound.size();
+    c[8] = restrictions.interference.size(); c[9] = adjacency.offsets.size();
+    c[10] = adjacency.entries.size();       c[11] = domains.transId.size();
+
+    std::string temporal = path + ".tmp" + std::to_string(getpid());
+    FILE* file = std::fopen(temporal.c_str(), "wb");
+    if (!file)
+        return false;
+
+    static const char relleno[8] = {0};
+    bool ok = std::fwrite(&header, sizeof(Header), 1, file) == 1
+            && std::fwrite(relleno, 1, alinear(sizeof(Header)) - sizeof(Header), file)
+                    == alinear(sizeof(Header)) - sizeof(Header)
+            && escribirTabla(file, domains.values) && escribirTabla(file, domains.offsets)
+            && escribirTabla(file, domains.sizes) && escribirTabla(file, domains.transOffset)
+            && escribirTabla(file, domains.transSize) && escribirTabla(file, restrictions.trans1)
+            && escribirTabla(file, restrictions.trans2) && escribirTabla(file, restrictions.bound)
+            && escribirTabla(file, restrictions.interference)
+            && escribirTabla(file, adjacency.offsets) && escribirTabla(file, adjacency.entries)
+            && escribirTabla(file, domains.transId);
+    ok = (std::fclose(file) == 0) && ok;
+
+    if (!ok || std::rename(temporal.c_str(), path.c_str()) != 0)
+    {
+        std::remove(temporal.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file InstanceCache.hpp
+ * @brief Headers declarations for class InstanceCache
+ *
+ */
+
+#ifndef INSTANCECACHE_HPP
+#define INSTANCECACHE_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Adjacency.hpp"
+#include "RestrictionStore.hpp"
+#include "DomainTable.hpp"
+
+/**
+ * @brief Binary copy of an already parsed instance
+ *
+ * The file keeps the structures the algorithms work with (domains, restrictions and
+ * adjacency), so a later run maps it and copies each table in one go instead of parsing
+ * the text files again. It stores the size and modification time of every text file it
+ * was built from and is ignored as soon as any of them changes, or when it was written
+ * by a different version of the format.
+ */
+
+class InstanceCache {
+public:
+    static bool load(const std::string& path, const std::vector<std::string>& sources, int TNumber,
+            DomainTable& domains, RestrictionStore& restrictions,
+            Adjacency& adjacency);
+
+    static bool save(const std::string& path, const std::vector<std::string>& sources, int TNumber,
+            const DomainTable& domains, const RestrictionStore& restrictions,
+            const Adjacency& adjacency);
+
+private:
+    static const uint32_t version;		///< Version of the format, files of other versions are not read
+
+    /**
+     * @brief Beginning of the file
+     *
+     * The tables follow the header in the order of the counters, each one starting at
+     * a multiple of 8 bytes.
+     */
+    struct Header
+    {
+        char magic[8];					///< "SQINST" to recognize the file
+        uint32_t version;				///< Version of the format
+        int32_t TNumber;				///< Limit of transistors used when the instance was parsed
+        uint64_t stamps[3][2];			///< Size and modification time in ns of each text file
+        uint64_t counts[12];			///< Number of elements of each table
+    };
+
+    static bool stamp(const std::vector<std::string>& sources, uint64_t stamps[3][2]);
+};
+
+#endif /* INSTANCECACHE_HPP */
@@ -0,0 +1,361 @@
+/**
+ * @file InstanceGenerator.cpp
+ * @brief Sources for the class InstanceGenerator
+ *
+ */
+
+#include "InstanceGenerator.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Buffered writer of text files made of integers
+ *
+ * The numbers are formatted with to_chars into a buffer that is written in blocks,
+ * much faster than a stream for files of hundreds of MB.
+ */
+
+class InstanceGenerator::Escritor {
+public:
+    explicit Escritor(const std::string& path) : file_(std::fopen(path.c_str(), "wb")), usado_(0)
+    {
+        if (!file_)
+            throw std::runtime_error("Can not write " + path);
+    }
+
+    ~Escritor()
+    {
+        if (file_)
+            std::fclose(file_);
+    }
+
+    /**
+     * @brief Writes an integer followed by a separator
+     */
+    void entero(long long valor, char separador)
+    {
+        if (usado_ + 32 > sizeof(buffer_))
+            vaciar();
+        char* fin = std::to_chars(buffer_ + usado_, buffer_ + sizeof(buffer_), valor).ptr;
+        *fin++ = separador;
+        usado_ = fin - buffer_;
+    }
+
+    /**
+     * @brief Writes a piece of text
+     */
+    void texto(const char* cadena)
+    {
+        for (; *cadena; ++cadena)
+        {
+            if (usado_ == sizeof(buffer_))
+                vaciar();
+            buffer_[usado_++] = *cadena;
+        }
+    }
+
+    /**
+     * @brief Writes the buffer to the file and closes it
+     */
+    void cerrar()
+    {
+        vaciar();
+        bool ok = std::fclose(file_) == 0;
+        file_ = nullptr;
+        if (!ok)
+            throw std::runtime_error("Error writing the instance");
+    }
+
+private:
+    void vaciar()
+    {
+        if (usado_ && std::fwrite(buffer_, 1, usado_, file_) != usado_)
+            throw std::runtime_error("Error writing the instance");
+        usado_ = 0;
+    }
+
+    FILE* file_;				///< File being written
+    char buffer_[1 << 16];		///< Text not written yet
+    size_t usado_;				///< Bytes of the buffer in use
+};
+
+
+/**
+ * @brief Default constructor
+ *
+ * @param [in]	options		parameters of the instance
+ */
+
+InstanceGenerator::InstanceGenerator(const GeneratorOptions& options) : options_(options)
+{
+    if (options_.transistors < 2)
+        throw std::invalid_argument("An instance needs at least 2 transistors");
+    if (options_.domains == 0 || options_.minDomain == 0 || options_.minDomain > options_.maxDomain)
+        throw std::invalid_argument("Wrong size of the domains");
+    if (options_.graph < 0 || options_.graph > 2 || options_.penalty < 0 || options_.penalty > 2)
+        throw std::invalid_argument("Unknown kind of graph or penalty");
+    if (options_.degree < 0 || options_.maxPenalty < 1 || options_.maxBound < 0 || options_.clusters == 0)
+        throw std::invalid_argument("Wrong parameters of the restrictions");
+}
+
+
+/**
+ * @brief Writes dom.txt, var.txt and ctr.txt
+ *
+ * Each file uses its own generator split from the seed, so changing for example the
+ * graph does not change the domains.
+ *
+ * @param [in]	dir		folder in which the files are written
+ * @return number of restrictions written
+ */
+
+unsigned long long InstanceGenerator::write(const std::string& dir)
+{
+    RandomGenerator rng(options_.seed);
+    RandomGenerator rngDom = rng.split(0), rngVar = rng.split(1), rngCtr = rng.split(2);
+    writeDomains(dir + "/dom.txt", rngDom);
+    writeTransistors(dir + "/var.txt", rngVar);
+    return writeRestrictions(dir + "/ctr.txt", rngCtr);
+}
+
+
+/**
+ * @brief Writes the domains, each one an increasing list of frequencies
+ *
+ * @param [in]		path	path of dom.txt
+ * @param [in,out]	rng		random number generator
+ */
+
+void InstanceGenerator::writeDomains(const std::string& path, RandomGenerator& rng)
+{
+    Escritor out(path);
+    for (unsigned d = 0; d < options_.domains; ++d)
+    {
+        int tam = rng.getInt(options_.minDomain, options_.maxDomain);
+        out.entero(d, ' ');
+        out.entero(tam, ' ');
+        int freq = rng.getInt(1, 20);
+        for (int i = 0; i < tam; ++i)
+        {
+            out.entero(freq, i + 1 < tam ? ' ' : '\n');
+            freq += rng.getInt(1, 14);
+        }
+    }
+    out.cerrar();
+}
+
+
+/**
+ * @brief Writes the transistors, with ids from 1 and a random domain each
+ *
+ * @param [in]		path	path of var.txt
+ * @param [in,out]	rng		random number generator
+ */
+
+void InstanceGenerator::writeTransistors(const std::string& path, RandomGenerator& rng)
+{
+    Escritor out(path);
+    for (unsigned t = 0; t < options_.transistors; ++t)
+    {
+        out.entero(t + 1, ' ');
+        out.entero(rng.getInt(0, options_.domains - 1), '\n');
+    }
+    out.cerrar();
+}
+
+
+/**
+ * @brief Writes the restrictions with the structure chosen in the options
+ *
+ * @param [in]		path	path of ctr.txt
+ * @param [in,out]	rng		random number generator
+ * @return number of restrictions written
+ */
+
+unsigned long long InstanceGenerator::writeRestrictions(const std::string& path, RandomGenerator& rng)
+{
+    Escritor out(path);
+    unsigned long long total = 0;
+    unsigned n = options_.transistors;
+
+    if (options_.graph == 0)
+        randomGraph(out, rng, 0, n, options_.degree / (n - 1), 0, total);
+    else if (options_.graph == 1)
+        geometricGraph(out, rng, total);
+    else
+        clusteredGraph(out, rng, total);
+
+    out.cerrar();
+    return total;
+}
+
+
+/**
+ * @brief Writes a random graph among consecutive transistors
+ *
+ * Instead of trying every pair, the gap to the next restricted pair is drawn from a
+ * geometric distribution (Batagelj and Brandes), so the cost is proportional to the
+ * number of restrictions. Pairs are visited as (v, w) with w < v and v increasing.
+ *
+ * @param [in,out]	out			writer of ctr.txt
+ * @param [in,out]	rng			random number generator
+ * @param [in]		first		first transistor of the graph
+ * @param [in]		n			number of transistors of the graph
+ * @param [in]		p			probability of each pair
+ * @param [in]		tamCluster	if it is not 0, pairs inside the same cluster of this size are left out
+ * @param [in,out]	total		number of restrictions written
+ */
+
+void InstanceGenerator::randomGraph(Escritor& out, RandomGenerator& rng, unsigned first, unsigned n,
+        double p, unsigned tamCluster, unsigned long long& total)
+{
+    if (p <= 0 || n < 2)
+        return;
+
+    double logQ = p < 1 ? std::log(1 - p) : 0;
+    long long v = 1, w = -1;
+    while (v < n)
+    {
+        double salto = p < 1 ? std::floor(std::log(1 - rng.getDouble()) / logQ) : 0;
+        w += 1 + (long long)std::min(salto, (double)n * n);
+        while (w >= v && v < n)
+        {
+            w -= v;
+            ++v;
+        }
+        if (v < n && (!tamCluster || v / tamCluster != w / tamCluster))
+        {
+            restriction(out, rng, first + v, first + w);
+            ++total;
+        }
+    }
+}
+
+
+/**
+ * @brief Writes a random geometric graph
+ *
+ * The unit square is split in cells as wide as the radius, so each transistor only
+ * compares its position with the ones of the 9 cells around it.
+ *
+ * @param [in,out]	out			writer of ctr.txt
+ * @param [in,out]	rng			random number generator
+ * @param [in,out]	total		number of restrictions written
+ */
+
+void InstanceGenerator::geometricGraph(Escritor& out, RandomGenerator& rng, unsigned long long& total)
+{
+    unsigned n = options_.transistors;
+    double radio = std::sqrt(options_.degree / (M_PI * n));
+    unsigned lado = std::max(1u, std::min(4096u, (unsigned)(1 / std::max(radio, 1e-9))));
+
+    std::vector<double> x(n), y(n);
+    std::vector<unsigned> celda(n), inicio(lado * lado + 1, 0), orden(n);
+    for (unsigned i = 0; i < n; ++i)
+    {
+        x[i] = rng.getDouble();
+        y[i] = rng.getDouble();
+        celda[i] = std::min(lado - 1, (unsigned)(y[i] * lado)) * lado + std::min(lado - 1, (unsigned)(x[i] * lado));
+        ++inicio[celda[i] + 1];
+    }
+    for (unsigned c = 1; c < inicio.size(); ++c)
+        inicio[c] += inicio[c-1];
+    std::vector<unsigned> siguiente(inicio.begin(), inicio.end() - 1);
+    for (unsigned i = 0; i < n; ++i)
+        orden[siguiente[celda[i]]++] = i;
+
+    std::vector<unsigned> vecinos;
+    for (unsigned i = 0; i < n; ++i)
+    {
+        int cx = celda[i] % lado, cy = celda[i] / lado;
+        vecinos.clear();
+        for (int dy = -1; dy <= 1; ++dy)
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+                int nx = cx + dx, ny = cy + dy;
+                if (nx < 0 || ny < 0 || nx >= (int)lado || ny >= (int)lado)
+                    continue;
+                unsigned c = ny * lado + nx;
+                for (unsigned k = inicio[c]; k < inicio[c+1]; ++k)
+                {
+                    unsigned j = orden[k];
+                    double ddx = x[i] - x[j], ddy = y[i] - y[j];
+                    if (j > i && ddx * ddx + ddy * ddy < radio * radio)
+                        vecinos.push_back(j);
+                }
+            }
+
+        // Por orden de id, para que el fichero no dependa de como se recorren las celdas
+        std::sort(vecinos.begin(), vecinos.end());
+        for (unsigned k = 0; k < vecinos.size(); ++k)
+            restriction(out, rng, i, vecinos[k]);
+        total += vecinos.size();
+    }
+}
+
+
+/**
+ * @brief Writes a clustered graph
+ *
+ * A fraction intra of the average degree comes from a random graph inside each
+ * cluster, the rest from a random graph over the pairs of different clusters.
+ *
+ * @param [in,out]	out			writer of ctr.txt
+ * @param [in,out]	rng			random number generator
+ * @param [in,out]	total		number of restrictions written
+ */
+
+void InstanceGenerator::clusteredGraph(Escritor& out, RandomGenerator& rng, unsigned long long& total)
+{
+    unsigned n = options_.transistors;
+    unsigned tam = (n + options_.clusters - 1) / options_.clusters;
+
+    for (unsigned first = 0; first < n; first += tam)
+    {
+        unsigned nc = std::min(tam, n - first);
+        if (nc > 1)
+            randomGraph(out, rng, first, nc, options_.intra * options_.degree / (nc - 1), 0, total);
+    }
+    
+    // Entre clusters se dejan fuera los pares del mismo cluster, que ya se han generado
+    if (n > tam)
+        randomGraph(out, rng, 0, n, (1 - options_.intra) * options_.degree / (n - tam), tam, total);
+}
+
+
+/**
+ * @brief Writes a restriction between two transistors with a random bound and interference
+ *
+ * @param [in,out]	out			writer of ctr.txt
+ * @param [in,out]	rng			random number generator
+ * @param [in]		t1			first transistor, counting from 0
+ * @param [in]		t2			second transistor, counting from 0
+ */
+
+void InstanceGenerator::restriction(Escritor& out, RandomGenerator& rng, unsigned t1, unsigned t2)
+{
+    int interferencia;
+    if (options_.penalty == 0)
+        interferencia = rng.getInt(1, options_.maxPenalty);
+    else if (options_.penalty == 1)
+    {
+        int niveles = 0;
+        for (int v = 1; v <= options_.maxPenalty / 10; v *= 10)
+            ++niveles;
+        interferencia = 1;
+        for (int e = rng.getInt(0, niveles); e > 0; --e)
+            interferencia *= 10;
+    } else
+        interferencia = options_.maxPenalty;
+
+    out.entero(t1 + 1, ' ');
+    out.entero(t2 + 1, ' ');
+    out.texto("C > ");
+    out.entero(rng.getInt(0, options_.maxBound), ' ');
+    out.entero(interferencia, '\n');
+}
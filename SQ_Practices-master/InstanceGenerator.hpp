@@ -0,0 +1,70 @@
+/**
+ * @file InstanceGenerator.hpp
+ * @brief Headers declarations for class InstanceGenerator
+ *
+ */
+
+#ifndef INSTANCEGENERATOR_HPP
+#define INSTANCEGENERATOR_HPP
+
+#include <string>
+#include <cstdint>
+
+#include "Random.hpp"
+
+/**
+ * @brief Parameters of a synthetic instance
+ */
+struct GeneratorOptions
+{
+    unsigned transistors = 1000;	///< Number of transistors
+    unsigned domains = 4;			///< Number of frequency domains
+    unsigned minDomain = 10;		///< Minimum number of frequencies of a domain
+    unsigned maxDomain = 40;		///< Maximum number of frequencies of a domain
+    double degree = 10;				///< Average number of restrictions of a transistor
+    int graph = 0;					///< Structure of the restrictions: 0 random, 1 geometric, 2 clustered
+    unsigned clusters = 10;			///< Number of clusters of the clustered graph
+    double intra = 0.8;				///< Fraction of the restrictions of the clustered graph inside a cluster
+    int penalty = 0;				///< Interference of the restrictions: 0 uniform, 1 powers of 10, 2 constant
+    int maxPenalty = 1000;			///< Maximum interference of a restriction
+    int maxBound = 60;				///< Maximum bound of a restriction
+    uint64_t seed = 1;				///< Seed, the same options and seed always give the same instance
+};
+
+
+/**
+ * @brief Generator of synthetic instances in the format of dom.txt, var.txt and ctr.txt
+ *
+ * The restrictions are written while they are generated, without keeping them in memory,
+ * so instances of millions of restrictions can be built. No pair of transistors gets
+ * more than one restriction:
+ *  - random: every pair is a restriction with the same probability.
+ *  - geometric: transistors are points of the unit square, the ones closer than the
+ *    radius that gives the average degree are restricted.
+ *  - clustered: transistors are split in clusters of consecutive ids, with a random
+ *    graph inside each cluster and a sparser one between different clusters.
+ */
+
+class InstanceGenerator {
+public:
+    explicit InstanceGenerator(const GeneratorOptions& options);
+
+    unsigned long long write(const std::string& dir);
+
+private:
+    class Escritor;
+
+    void writeDomains(const std::string& path, RandomGenerator& rng);
+    void writeTransistors(const std::string& path, RandomGenerator& rng);
+    unsigned long long writeRestrictions(const std::string& path, RandomGenerator& rng);
+
+    void randomGraph(Escritor& out, RandomGenerator& rng, unsigned first, unsigned n, double p,
+            unsigned tamCluster, unsigned long long& total);
+    void geometricGraph(Escritor& out, RandomGenerator& rng, unsigned long long& total);
+    void clusteredGraph(Escritor& out, RandomGenerator& rng, unsigned long long& total);
+    void restriction(Escritor& out, RandomGenerator& rng, unsigned t1, unsigned t2);
+
+    GeneratorOptions options_;		///< Parameters of the instance
+};
+
+#endif /* INSTANCEGENERATOR_HPP */
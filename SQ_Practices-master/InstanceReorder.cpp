@@ -0,0 +1,141 @@
+/**
+ * @file InstanceReorder.cpp
+ * @brief Sources for the class InstanceReorder
+ *
+ */
+
+#include "InstanceReorder.hpp"
+#include "Restriction.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief Renumbers the transistors of an instance and rebuilds its tables
+ *
+ * The restrictions are sorted by their first transistor, which after the renumbering is the
+ * lower of the two, and then by the second one; the restrictions of each transistor in the
+ * adjacency are sorted by neighbour.
+ * @param [in]		metodo			Order of the transistors, 0 = BFS		1 = reverse Cuthill-McKee
+ * @param [in,out]	domains			Frequencies available to each transistor
+ * @param [in,out]	restrictions	Restrictions of the instance
+ * @param [in,out]	adjacency		Restrictions incident to each transistor
+ */
+
+void InstanceReorder::reorder(int metodo, DomainTable& domains, RestrictionStore& restrictions,
+        Adjacency& adjacency)
+{
+    unsigned numTrans = domains.numTransistors();
+    std::vector<unsigned> orden;
+    order(metodo, adjacency, orden);
+    std::vector<unsigned> nuevo(numTrans);
+    for (unsigned i = 0; i < numTrans; ++i)
+        nuevo[orden[i]] = i;
+
+    // Dominios
+    std::vector<unsigned> transOffset(numTrans);
+    std::vector<int> transSize(numTrans);
+    std::vector<unsigned> transId(domains.transId.size());
+    for (unsigned i = 0; i < numTrans; ++i)
+    {
+        transOffset[i] = domains.transOffset[orden[i]];
+        transSize[i] = domains.transSize[orden[i]];
+        if (!transId.empty())
+            transId[i] = domains.transId[orden[i]];
+    }
+    domains.transOffset.swap(transOffset);
+    domains.transSize.swap(transSize);
+    domains.transId.swap(transId);
+
+    // Restricciones
+    std::vector<Restriction> lista(restrictions.size());
+    for (unsigned k = 0; k < restrictions.size(); ++k)
+    {
+        unsigned a = nuevo[restrictions.trans1[k]];
+        unsigned b = nuevo[restrictions.trans2[k]];
+        lista[k] = Restriction{std::min(a, b), std::max(a, b), restrictions.bound[k], restrictions.interference[k]};
+    }
+    std::stable_sort(lista.begin(), lista.end(), [](const Restriction& x, const Restriction& y) {
+        return x.trans1 < y.trans1 || (x.trans1 == y.trans1 && x.trans2 < y.trans2);
+    });
+    for (unsigned k = 0; k < lista.size(); ++k)
+    {
+        restrictions.trans1[k] = lista[k].trans1;
+        restrictions.trans2[k] = lista[k].trans2;
+        restrictions.bound[k] = lista[k].bound;
+        restrictions.interference[k] = lista[k].interference;
+    }
+
+    // Adyacencia
+    Adjacency reordenada;
+    reordenada.offsets.assign(1, 0);
+    reordenada.entries.reserve(adjacency.entries.size());
+    for (unsigned i = 0; i < numTrans; ++i)
+    {
+        unsigned t = orden[i];
+        for (unsigned e = adjacency.offsets[t]; e < adjacency.offsets[t+1]; ++e)
+        {
+            AdjRestriction r = adjacency.entries[e];
+            r.neighbour = nuevo[r.neighbour];
+            reordenada.entries.push_back(r);
+        }
+        std::stable_sort(reordenada.entries.begin() + reordenada.offsets.back(), reordenada.entries.end(),
+                [](const AdjRestriction& x, const AdjRestriction& y) { return x.neighbour < y.neighbour; });
+        reordenada.offsets.push_back(reordenada.entries.size());
+    }
+    adjacency = std::move(reordenada);
+}
+
+
+/**
+ * @brief Computes the new order of the transistors
+ *
+ * Each connected component is walked in breadth from its transistor of lowest degree. With
+ * Cuthill-McKee the neighbours of each transistor are visited from the lowest degree up and
+ * the whole order is reversed at the end, which usually lowers the bandwidth of the graph
+ * further than a plain walk.
+ * @param [in]	metodo		Order of the transistors, 0 = BFS		1 = reverse Cuthill-McKee
+ * @param [in]	adjacency	Restrictions incident to each transistor
+ * @param [out]	orden		Transistor that goes to each position
+ */
+
+void InstanceReorder::order(int metodo, const Adjacency& adjacency, std::vector<unsigned>& orden)
+{
+    unsigned numTrans = adjacency.offsets.size() - 1;
+    auto grado = [&](unsigned t) { return adjacency.offsets[t+1] - adjacency.offsets[t]; };
+    auto menorGrado = [&](unsigned a, unsigned b) { return grado(a) < grado(b); };
+
+    std::vector<unsigned> inicios(numTrans);
+    for (unsigned t = 0; t < numTrans; ++t)
+        inicios[t] = t;
+    std::stable_sort(inicios.begin(), inicios.end(), menorGrado);
+
+    orden.clear();
+    orden.reserve(numTrans);
+    std::vector<bool> visitado(numTrans, false);
+    for (unsigned inicio : inicios)
+    {
+        if (visitado[inicio])
+            continue;
+        visitado[inicio] = true;
+        orden.push_back(inicio);
+        for (unsigned i = orden.size() - 1; i < orden.size(); ++i)
+        {
+            unsigned t = orden[i];
+            unsigned primero = orden.size();
+            for (unsigned e = adjacency.offsets[t]; e < adjacency.offsets[t+1]; ++e)
+            {
+                unsigned vecino = adjacency.entries[e].neighbour;
+                if (!visitado[vecino])
+                {
+                    visitado[vecino] = true;
+                    orden.push_back(vecino);
+                }
+            }
+            if (metodo == 1)
+                std::stable_sort(orden.begin() + primero, orden.end(), menorGrado);
+        }
+    }
+
+    if (metodo == 1)
+        std::reverse(orden.begin(), orden.end());
+}
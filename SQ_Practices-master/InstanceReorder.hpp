@@ -0,0 +1,35 @@
+/**
+ * @file InstanceReorder.hpp
+ * @brief Headers declarations for class InstanceReorder
+ *
+ */
+
+#ifndef INSTANCEREORDER_HPP
+#define INSTANCEREORDER_HPP
+
+#include <vector>
+
+#include "Adjacency.hpp"
+#include "RestrictionStore.hpp"
+#include "DomainTable.hpp"
+
+/**
+ * @brief Renumbers the transistors of an instance so that neighbours get close numbers
+ *
+ * The evaluation reads the frequency of both transistors of each restriction and the
+ * 2-point cross swaps a window of consecutive transistors, so with neighbours numbered close
+ * to each other the reads stay in cache and the windows hold pieces of the graph. The ids of
+ * var.txt move with their transistors in DomainTable::transId, so the assignments written
+ * with them are still in terms of the original transistors.
+ */
+
+class InstanceReorder {
+public:
+    static void reorder(int metodo, DomainTable& domains, RestrictionStore& restrictions,
+            Adjacency& adjacency);
+
+private:
+    static void order(int metodo, const Adjacency& adjacency, std::vector<unsigned>& orden);
+};
+
+#endif /* INSTANCEREORDER_HPP */
@@ -0,0 +1,103 @@
+/**
+ * @file InstanceSplitter.cpp
+ * @brief Sources for the class InstanceSplitter
+ *
+ */
+
+#include "InstanceSplitter.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief Finds the connected components of the restriction graph and builds an instance for each one
+ *
+ * @param [in]	domains		Frequencies available to each transistor
+ * @param [in]	restrictions	Restrictions of the instance
+ * @param [in]	adjacency	Restrictions incident to each transistor
+ * @param [out]	components	Components with at least one restriction, in the order of their first transistor
+ * @param [out]	isolated	Transistors without restrictions, any frequency is as good as the others for them
+ */
+
+void InstanceSplitter::split(const DomainTable& domains, const RestrictionStore& restrictions,
+        const Adjacency& adjacency, std::vector<SubInstance>& components,
+        std::vector<unsigned>& isolated)
+{
+    unsigned numTrans = domains.numTransistors();
+    components.clear();
+    isolated.clear();
+
+    // Recorrido en anchura desde cada transistor que aun no tiene componente
+    std::vector<int> componente(numTrans, -1);
+    std::vector<unsigned> cola;
+    for (unsigned t = 0; t < numTrans; ++t)
+    {
+        if (componente[t] >= 0)
+            continue;
+        if (adjacency.offsets[t] == adjacency.offsets[t+1])
+        {
+            isolated.push_back(t);
+            continue;
+        }
+
+        int c = components.size();
+        cola.assign(1, t);
+        componente[t] = c;
+        for (unsigned i = 0; i < cola.size(); ++i)
+            for (unsigned k = adjacency.offsets[cola[i]]; k < adjacency.offsets[cola[i]+1]; ++k)
+            {
+                unsigned vecino = adjacency.entries[k].neighbour;
+                if (componente[vecino] < 0)
+                {
+                    componente[vecino] = c;
+                    cola.push_back(vecino);
+                }
+            }
+        std::sort(cola.begin(), cola.end());
+        components.emplace_back();
+        components.back().transistors = cola;
+    }
+
+    // Numero de cada transistor dentro de su componente
+    std::vector<unsigned> local(numTrans);
+    for (SubInstance& sub : components)
+        for (unsigned i = 0; i < sub.transistors.size(); ++i)
+            local[sub.transistors[i]] = i;
+
+    for (SubInstance& sub : components)
+    {
+        unsigned n = sub.transistors.size();
+        sub.domains.values = domains.values;
+        sub.domains.offsets = domains.offsets;
+        sub.domains.sizes = domains.sizes;
+        sub.domains.transOffset.resize(n);
+        sub.domains.transSize.resize(n);
+        sub.domains.transId.resize(domains.transId.empty() ? 0 : n);
+        sub.adjacency.offsets.assign(1, 0);
+        for (unsigned i = 0; i < n; ++i)
+        {
+            unsigned t = sub.transistors[i];
+            sub.domains.transOffset[i] = domains.transOffset[t];
+            sub.domains.transSize[i] = domains.transSize[t];
+            if (!domains.transId.empty())
+                sub.domains.transId[i] = domains.transId[t];
+
+            for (unsigned k = adjacency.offsets[t]; k < adjacency.offsets[t+1]; ++k)
+            {
+                AdjRestriction r = adjacency.entries[k];
+                r.neighbour = local[r.neighbour];
+                sub.adjacency.entries.push_back(r);
+            }
+            sub.adjacency.offsets.push_back(sub.adjacency.entries.size());
+        }
+    }
+
+    // Cada restriccion va a la componente de sus transistores, sin cambiar de orden
+    for (unsigned k = 0; k < restrictions.size(); ++k)
+    {
+        RestrictionStore& destino = components[componente[restrictions.trans1[k]]].restrictions;
+        destino.trans1.push_back(local[restrictions.trans1[k]]);
+        destino.trans2.push_back(local[restrictions.trans2[k]]);
+        destino.bound.push_back(restrictions.bound[k]);
+        destino.interference.push_back(restrictions.interference[k]);
+    }
+}
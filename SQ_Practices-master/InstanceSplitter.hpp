@@ -0,0 +1,46 @@
+/**
+ * @file InstanceSplitter.hpp
+ * @brief Headers declarations for class InstanceSplitter
+ *
+ */
+
+#ifndef INSTANCESPLITTER_HPP
+#define INSTANCESPLITTER_HPP
+
+#include <vector>
+
+#include "Adjacency.hpp"
+#include "RestrictionStore.hpp"
+#include "DomainTable.hpp"
+
+/**
+ * @brief Connected component of the restriction graph, as an instance of its own
+ *
+ * The transistors of the component keep their relative order, so the restrictions keep
+ * the order they had in the whole instance.
+ */
+struct SubInstance
+{
+    std::vector<unsigned> transistors;	///< Transistor of the whole instance of each transistor of the component
+    DomainTable domains;				///< Frequencies available to each transistor
+    RestrictionStore restrictions;		///< Restrictions among the transistors of the component
+    Adjacency adjacency;				///< Restrictions incident to each transistor
+};
+
+
+/**
+ * @brief Splits an instance into the connected components of its restriction graph
+ *
+ * Two transistors are in the same component when a chain of restrictions joins them, so
+ * the interference of an assignment is the sum of the interferences of its components and
+ * each one can be solved on its own.
+ */
+
+class InstanceSplitter {
+public:
+    static void split(const DomainTable& domains, const RestrictionStore& restrictions,
+            const Adjacency& adjacency, std::vector<SubInstance>& components,
+            std::vector<unsigned>& isolated);
+};
+
+#endif /* INSTANCESPLITTER_HPP */
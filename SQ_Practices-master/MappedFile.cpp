@@ -0,0 +1,96 @@
+/**
+ * @file MappedFile.cpp
+ * @brief Sources for the class MappedFile
+ *
+ */
+
+#include "MappedFile.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Default constructor, maps the whole file
+ *
+ * @param [in]	path	path of the file
+ */
+
+MappedFile::MappedFile(const std::string& path) : mapa_(nullptr), tam_(0), good_(false)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0)
+    {
+        tam_ = info.st_size;
+        if (tam_ == 0)
+            good_ = true;
+        else
+        {
+            mapa_ = mmap(nullptr, tam_, PROT_READ, MAP_SHARED, fd, 0);
+            if (mapa_ == MAP_FAILED)
+                mapa_ = nullptr;
+            else
+            {
+                madvise(mapa_, tam_, MADV_SEQUENTIAL);
+                good_ = true;
+            }
+        }
+    }
+    close(fd);
+    if (!good_)
+        tam_ = 0;
+}
+
+
+/**
+ * @brief Destroyer
+ *
+ * Unmaps the file
+ */
+
+MappedFile::~MappedFile()
+{
+    if (mapa_)
+        munmap(mapa_, tam_);
+}
+
+
+/**
+ * @brief Whether the file could be opened and mapped
+ *
+ * @return true if the contents of the file can be read
+ */
+
+bool MappedFile::good() const
+{
+    return good_;
+}
+
+
+/**
+ * @brief Gets the contents of the file
+ *
+ * @return pointer to the first byte, null for an empty file
+ */
+
+const char* MappedFile::data() const
+{
+    return static_cast<const char*>(mapa_);
+}
+
+
+/**
+ * @brief Gets the size of the file
+ *
+ * @return size in bytes
+ */
+
+size_t MappedFile::size() const
+{
+    return tam_;
+}
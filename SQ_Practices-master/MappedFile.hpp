@@ -0,0 +1,38 @@
+/**
+ * @file MappedFile.hpp
+ * @brief Headers declarations for class MappedFile
+ *
+ */
+
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <string>
+#include <cstddef>
+
+/**
+ * @brief File mapped read only in memory for as long as the object lives
+ *
+ * The pages are shared with the page cache, so reading the file does not copy it and
+ * several processes mapping the same file use a single copy of it.
+ */
+
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    virtual ~MappedFile();
+
+    bool good() const;
+    const char* data() const;
+    size_t size() const;
+
+private:
+    MappedFile(const MappedFile& orig);
+    MappedFile& operator=(const MappedFile& orig);
+
+    void* mapa_;			///< Beginning of the mapping, null if the file is empty or could not be mapped
+    size_t tam_;			///< Size of the file in bytes
+    bool good_;				///< Whether the file could be opened
+};
+
+#endif /* MAPPEDFILE_HPP */
@@ -0,0 +1,60 @@
+/**
+ * @file OverflowPolicy.hpp
+ * @brief Policies used by the evaluation kernels to detect an overflow of the interference
+ *
+ */
+
+#ifndef OVERFLOWPOLICY_HPP
+#define OVERFLOWPOLICY_HPP
+
+#include <climits>
+#include <stdexcept>
+
+#include "sec_op.hpp"
+
+/**
+ * @brief Accumulates in 64 bits and checks once, when the result is converted back to int
+ *
+ * A sum of 32 bits terms can not overflow 64 bits before it has about 2^32 terms, far more
+ * than the restrictions of an instance, so the loops are free of branches and the compiler
+ * can vectorize them.
+ */
+struct CheckedAtEnd
+{
+    typedef long long Accumulator;
+
+    static Accumulator add(Accumulator a, Accumulator b) { return a + b; }
+    static Accumulator sub(Accumulator a, Accumulator b) { return a - b; }
+
+    static int result(Accumulator a)
+    {
+        if (a > INT_MAX || a < INT_MIN)
+            throw std::overflow_error("Integer Overflow");
+        return (int)a;
+    }
+};
+
+
+/**
+ * @brief Checks every single operation with sec_sum and sec_diff
+ *
+ * Slower, but it stops at the exact operation that overflows. Chosen by building with
+ * -DSQ_CHECK_EVERY_ADD, to validate the default policy.
+ */
+struct CheckedPerAdd
+{
+    typedef int Accumulator;
+
+    static Accumulator add(Accumulator a, Accumulator b) { return sec_sum(a, b); }
+    static Accumulator sub(Accumulator a, Accumulator b) { return sec_diff(a, b); }
+    static int result(Accumulator a) { return a; }
+};
+
+
+#ifdef SQ_CHECK_EVERY_ADD
+typedef CheckedPerAdd DefaultOverflowPolicy;
+#else
+typedef CheckedAtEnd DefaultOverflowPolicy;
+#endif
+
+#endif /* OVERFLOWPOLICY_HPP */
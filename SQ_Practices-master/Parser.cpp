@@ -5,10 +5,92 @@
 */
 
 #include "Parser.hpp"
+#include "MappedFile.hpp"
+#include "ThreadPool.hpp"
+
+#include <charconv>
+#include <string_view>
+#include <cstring>
+#include <algorithm>
+
+/**
+ * @brief Skips the spaces and tabs of a line
+ *
+ * @param [in]	pos		current position in the line
+ * @param [in]	fin		end of the line
+ * @return position of the first character that is not blank, or fin
+ */
+
+static inline const char* saltarBlancos(const char* pos, const char* fin)
+{
+    while (pos < fin && (*pos == ' ' || *pos == '\t' || *pos == '\r'))
+        ++pos;
+    return pos;
+}
+
+
+/**
+ * @brief Reads the next integer of a line
+ *
+ * @param [in,out]	pos		current position in the line, moved past the integer
+ * @param [in]		fin		end of the line
+ * @param [out]		valor	integer read
+ * @return false if there are no more tokens in the line
+ */
+
+static bool leerEntero(const char*& pos, const char* fin, int& valor)
+{
+    pos = saltarBlancos(pos, fin);
+    if (pos == fin)
+        return false;
+    if (*pos == '+')
+        ++pos;
+    std::from_chars_result r = std::from_chars(pos, fin, valor);
+    if (r.ec != std::errc() || (r.ptr < fin && *r.ptr != ' ' && *r.ptr != '\t' && *r.ptr != '\r'))
+        throw std::domain_error("Wrong number in the instance files");
+    pos = r.ptr;
+    return true;
+}
+
+
+/**
+ * @brief Reads the next word of a line
+ *
+ * @param [in,out]	pos		current position in the line, moved past the word
+ * @param [in]		fin		end of the line
+ * @return the word, empty if there are no more tokens in the line
+ */
+
+static std::string_view leerPalabra(const char*& pos, const char* fin)
+{
+    pos = saltarBlancos(pos, fin);
+    const char* inicio = pos;
+    while (pos < fin && *pos != ' ' && *pos != '\t' && *pos != '\r')
+        ++pos;
+    return std::string_view(inicio, pos - inicio);
+}
+
+
+/**
+ * @brief Gets the end of the line that starts at a given position
+ *
+ * @param [in]	pos		beginning of the line
+ * @param [in]	fin		end of the buffer
+ * @return position of the '\n' ending the line, or fin
+ */
+
+static inline const char* finLinea(const char* pos, const char* fin)
+{
+    const char* salto = static_cast<const char*>(std::memchr(pos, '\n', fin - pos));
+    return salto ? salto : fin;
+}
+
 
 /**
  * @brief Generates a matrix with the different levels of frequencies given by "dom.txt"
  *
+ * Each line holds the number of the domain, the number of frequencies and the frequencies.
+ *
  * @param [in]		path		path in which the file is stored
  * @param [in,out]	results	data structure in which the results will be stored
  */
@@ -16,29 +98,28 @@
 void Parser::FRangeParse(std::string path,
                          std::vector<std::vector<int>>& results)
 {
-    std::ifstream input_file;
-    input_file.open(path);
-    if(!input_file.good())
+    MappedFile file(path);
+    if(!file.good())
         throw std::domain_error("File not found");
 
-    std::string currentLine; 
-    int indx_line = 0;
-    while(std::getline(input_file, currentLine))
+    const char* fin = file.data() + file.size();
+    for (const char* pos = file.data(); pos < fin; ++pos)
     {
-        if(currentLine == " ")
-            continue;
-        std::string index, frec;
-        std::stringstream iss(currentLine);
-        iss >> index;
-        
-        results.push_back(*(new std::vector<int>()));
-        do {
-            iss >> frec;
-            int frec_n = std::stoi(frec);
-            results[indx_line].push_back(frec_n);
-
-        }  while(iss);
-        ++indx_line;
+        const char* linea = finLinea(pos, fin);
+        int index, count, frec;
+        if (leerEntero(pos, linea, index))
+        {
+            if (!leerEntero(pos, linea, count) || count < 0)
+                throw std::domain_error("Domain without frequencies in " + path);
+            
+            results.emplace_back();
+            results.back().reserve(count);
+            while (leerEntero(pos, linea, frec))
+                results.back().push_back(frec);
+            if (results.back().size() != (unsigned)count)
+                throw std::domain_error("Wrong number of frequencies in " + path);
+        }
+        pos = linea;
     }
 }
 
@@ -46,10 +127,13 @@ void Parser::FRangeParse(std::string path,
 /**
  * @brief Generates a vector with the transistors given by "var.txt"
  *
+ * The transistors are read until one whose id reaches TNumber, which is still included.
+ *
  * @param [in]		path				path in which the file is stored
  * @param [in]		frecs				data structure in which the frequencies range of each transistor will be stored
  * @param [in,out]	result				data structure in which the results will be stored
- * @param [in,out]	equivalenceIndex	refactoring index to avoid gaps between transistors
+ * @param [in,out]	equivalenceIndex	refactoring index to avoid gaps between transistors, indexed by id.
+ * 										Ids without transistor hold -1
  * @param [in,out]	TNumber				the total number of transistors of the file
  * @return The total number of transistors generated
  */
@@ -59,32 +143,31 @@ int Parser::TParse(std::string path,
         std::vector<Transistor>& result, std::vector<int>& equivalenceIndex,
         int TNumber)
 {
-    std::ifstream input_file;
-    input_file.open(path);
-    if(!input_file.good())
+    MappedFile file(path);
+    if(!file.good())
         throw std::domain_error("File not found");
 
-    std::string currentLine;
     int indx_trans = 0;
-    while(std::getline(input_file, currentLine) && indx_trans < TNumber)
+    const char* fin = file.data() + file.size();
+    for (const char* pos = file.data(); pos < fin && indx_trans < TNumber; ++pos)
     {
-        int  trans, nRange;
-        std::stringstream iss(currentLine);
-
-        if(currentLine == " ")
-            continue;
-
-        iss >> trans;
-        iss >> nRange;
-
-        indx_trans = trans;
-
-        Transistor aux(trans, nRange, frecs);
-        result.push_back(aux);
-
+        const char* linea = finLinea(pos, fin);
+        int trans, nRange;
+        if (leerEntero(pos, linea, trans))
+        {
+            if (!leerEntero(pos, linea, nRange) || trans < 0)
+                throw std::domain_error("Wrong transistor in " + path);
+            
+            indx_trans = trans;
+            result.emplace_back(trans, nRange, frecs);
+        }
+        pos = linea;
     }
     
-    equivalenceIndex.reserve(indx_trans+1);
+    int maximo = -1;
+    for (unsigned i = 0; i < result.size(); ++i)
+        maximo = std::max(maximo, result[i].getNumID());
+    equivalenceIndex.assign(maximo + 1, -1);
     for (unsigned i = 0; i < result.size(); ++i)
         equivalenceIndex[result[i].getNumID()] = i;
     
@@ -94,73 +177,198 @@ int Parser::TParse(std::string path,
 }
 
 
+/**
+ * @brief Reads the restrictions of a piece of "ctr.txt" made of whole lines
+ *
+ * Restrictions whose transistors were not read by TParse are left out.
+ *
+ * @param [in]		pos					beginning of the piece
+ * @param [in]		fin					end of the piece
+ * @param [in,out]	restrictions		data structure in which the restrictions will be stored
+ * @param [in]		equivalenceIndex	refactoring index to avoid gaps between transistors
+ */
+
+static void leerRestricciones(const char* pos, const char* fin, std::vector<Restriction>& restrictions,
+        const std::vector<int>& equivalenceIndex)
+{
+    for (; pos < fin; ++pos)
+    {
+        const char* linea = finLinea(pos, fin);
+        int trans1, trans2, bound, interference;
+        if (leerEntero(pos, linea, trans1) && leerEntero(pos, linea, trans2))
+        {
+            std::string_view letter = leerPalabra(pos, linea);
+            if (letter != "D")
+            {
+                leerPalabra(pos, linea);
+                if (!leerEntero(pos, linea, bound) || !leerEntero(pos, linea, interference))
+                    throw std::domain_error("Wrong restriction in the instance files");
+                
+                if (trans1 >= 0 && trans2 >= 0 && (unsigned)trans1 < equivalenceIndex.size()
+                        && (unsigned)trans2 < equivalenceIndex.size()
+                        && equivalenceIndex[trans1] >= 0 && equivalenceIndex[trans2] >= 0)
+                {
+                    Restriction aux; aux.trans1 = equivalenceIndex[trans1]; aux.trans2 = equivalenceIndex[trans2];
+                    aux.bound = bound; aux.interference = interference;
+                    restrictions.push_back(aux);
+                }
+            }
+        }
+        pos = linea;
+    }
+}
+
+
 /**
  * @brief Generates a list of transistors given by the file "ctr.txt"
  *
+ * Big files are cut at line boundaries into pieces that are read in parallel, the
+ * restrictions keep the order of the file.
+ *
  * @param [in]		path				path in which the file is stored
  * @param [in,out]	restrictions		data structure in which the restrictions will be stored
  * @param [in,out]	equivalenceIndex	refactoring index to avoid gaps between transistors
- * @return The number of transistors returned.
+ * @param [in]		hilos				threads used to read the file, 0 uses every hardware thread
  */
 
 void Parser::RTParse(std::string path, std::vector<Restriction>& restrictions,
-        std::vector<int>& equivalenceIndex)
+        std::vector<int>& equivalenceIndex, unsigned hilos)
 {
-    std::ifstream input_file;
-    input_file.open(path);
-    if(!input_file.good())
+    MappedFile file(path);
+    if(!file.good())
         throw std::domain_error("File not found");
     
-    std::string currentLine;
-    while(std::getline(input_file, currentLine))
+    // Trozos de al menos 1 MiB, por debajo no compensa lanzar hilos
+    const size_t minimo = 1 << 20;
+    if (hilos == 0)
+        hilos = std::thread::hardware_concurrency();
+    size_t nTrozos = std::max<size_t>(1, std::min<size_t>(std::max(hilos, 1u), file.size() / minimo));
+    
+    const char* fin = file.data() + file.size();
+    std::vector<const char*> cortes(nTrozos + 1, fin);
+    cortes[0] = file.data();
+    for (size_t i = 1; i < nTrozos; ++i)
     {
-        int  trans1, trans2, bound, interference;
-        std::string letter, mock;
-        std::stringstream iss(currentLine), mockstream(currentLine);
-        mockstream >> mock;
-        mockstream >> mock;
-        if(currentLine == " " || !mockstream)
-            continue;
-
-        iss >> trans1;
-        iss >> trans2;
-        
-        iss >> letter;
-        
-        if(letter == "D")
-            continue;
-        
-        iss >> letter;
-        
-        iss >> bound;
-        iss >> interference;
-        
-        Restriction aux; aux.trans1 = equivalenceIndex[trans1]; aux.trans2 = equivalenceIndex[trans2];
-        aux.bound = bound; aux.interference = interference;
-
-        restrictions.push_back(aux);
+        const char* corte = file.data() + file.size() / nTrozos * i;
+        corte = std::max(corte, cortes[i-1]);
+        cortes[i] = corte < fin ? finLinea(corte, fin) : fin;
     }
+    
+    if (nTrozos == 1)
+    {
+        leerRestricciones(cortes[0], fin, restrictions, equivalenceIndex);
+        return;
+    }
+    
+    std::vector<std::vector<Restriction>> trozos(nTrozos);
+    ThreadPool pool(nTrozos);
+    pool.parallelFor(nTrozos, [&](unsigned i) {
+        leerRestricciones(cortes[i], cortes[i+1], trozos[i], equivalenceIndex);
+    });
+    
+    size_t total = restrictions.size();
+    for (size_t i = 0; i < nTrozos; ++i)
+        total += trozos[i].size();
+    restrictions.reserve(total);
+    for (size_t i = 0; i < nTrozos; ++i)
+        restrictions.insert(restrictions.end(), trozos[i].begin(), trozos[i].end());
 }
 
 
 /**
- * @brief Calculates indexes of the restrictions that we will have to be taken into account
+ * @brief Builds the adjacency of every transistor, listing all the restrictions in which it takes part
  *
- * @param [in,out]	transistors_	 	vector with the transistors
- * @param [in,out]	restrictions_	 	vector with the restrictions
- * @param [in,out]	result		 		Indexes of the restrictions that we will have to be taken into account
+ * @param [in]		transistors_	 	vector with the transistors
+ * @param [in]		restrictions_	 	vector with the restrictions
+ * @param [in,out]	result		 		adjacency in which the incident restrictions will be stored
  */
 
-void Parser::genIndexTransRestr(std::vector<Transistor>& transistors_, 
-                std::vector<Restriction>& restrictions_, std::vector<unsigned>& result)
+void Parser::genAdjacency(std::vector<Transistor>& transistors_,
+                std::vector<Restriction>& restrictions_, Adjacency& result)
 {
-    unsigned k = 0;
-    for(unsigned i = 0; i < transistors_.size() && k <= restrictions_.size(); ++i)
+    std::vector<unsigned>& offsets = result.offsets;
+    offsets.assign(transistors_.size() + 1, 0);
+
+    for (unsigned k = 0; k < restrictions_.size(); ++k)
     {
-        result.push_back(k);
-        while (restrictions_[k].trans1 == i)
-            ++k;
-        
+        ++offsets[restrictions_[k].trans1 + 1];
+        ++offsets[restrictions_[k].trans2 + 1];
+    }
+    for (unsigned i = 1; i < offsets.size(); ++i)
+        offsets[i] += offsets[i-1];
+
+    result.entries.resize(offsets.back());
+    std::vector<unsigned> next(offsets.begin(), offsets.end() - 1);
+    for (unsigned k = 0; k < restrictions_.size(); ++k)
+    {
+        const Restriction& r = restrictions_[k];
+        AdjRestriction aux; aux.bound = r.bound; aux.interference = r.interference;
+
+        aux.neighbour = r.trans2;
+        result.entries[next[r.trans1]++] = aux;
+
+        aux.neighbour = r.trans1;
+        result.entries[next[r.trans2]++] = aux;
     }
 }
 
+
+/**
+ * @brief Copies the restrictions into a structure of arrays, the layout used by the evaluation kernels
+ *
+ * @param [in]		restrictions_	 	vector with the restrictions
+ * @param [in,out]	result		 		structure of arrays in which the restrictions will be stored
+ */
+
+void Parser::genRestrictionStore(std::vector<Restriction>& restrictions_, RestrictionStore& result)
+{
+    unsigned n = restrictions_.size();
+    result.trans1.resize(n);
+    result.trans2.resize(n);
+    result.bound.resize(n);
+    result.interference.resize(n);
+
+    for (unsigned k = 0; k < n; ++k)
+    {
+        result.trans1[k] = restrictions_[k].trans1;
+        result.trans2[k] = restrictions_[k].trans2;
+        result.bound[k] = restrictions_[k].bound;
+        result.interference[k] = restrictions_[k].interference;
+    }
+}
+
+
+/**
+ * @brief Flattens the frequencies matrix into a single table and stores the domain of each transistor
+ *
+ * @param [in]		frecs			 	frequencies matrix given by "dom.txt"
+ * @param [in]		transistors_	 	vector with the transistors
+ * @param [in,out]	result		 		table in which the domains will be stored
+ */
+
+void Parser::genDomainTable(std::vector<std::vector<int>>& frecs,
+                std::vector<Transistor>& transistors_, DomainTable& result)
+{
+    result.values.clear();
+    result.offsets.resize(frecs.size());
+    result.sizes.resize(frecs.size());
+    for (unsigned d = 0; d < frecs.size(); ++d)
+    {
+        result.offsets[d] = result.values.size();
+        result.sizes[d] = frecs[d].size();
+        result.values.insert(result.values.end(), frecs[d].begin(), frecs[d].end());
+    }
+
+    result.transOffset.resize(transistors_.size());
+    result.transSize.resize(transistors_.size());
+    result.transId.resize(transistors_.size());
+    for (unsigned i = 0; i < transistors_.size(); ++i)
+    {
+        int nRange = transistors_[i].getNRange();
+        if (nRange < 0 || (unsigned)nRange >= frecs.size())
+            throw std::domain_error("Transistor with an unknown range of frequencies");
+        result.transOffset[i] = result.offsets[nRange];
+        result.transSize[i] = result.sizes[nRange];
+        result.transId[i] = transistors_[i].getNumID();
+    }
+}
@@ -14,6 +14,9 @@
 
 #include "Transistor.hpp"
 #include "Restriction.hpp"
+#include "Adjacency.hpp"
+#include "RestrictionStore.hpp"
+#include "DomainTable.hpp"
 
 /**
  * @brief Class Parser, with the objective of translating the information stored in the different .txt files regarding
@@ -24,15 +27,20 @@ class Parser {
     static void FRangeParse(std::string path, std::vector<std::vector<int>>& results);
 
     static void RTParse(std::string path, std::vector<Restriction>& restrictions,
-                        std::vector<int>& equivalenceIndex); 
+                        std::vector<int>& equivalenceIndex, unsigned hilos = 0);
 
     static int TParse(std::string path,
                       std::vector<std::vector<int>>* frecs, 
                       std::vector<Transistor>& result, std::vector<int>& equivalenceIndex,
                       int TNumber = INT_MAX);
     
-    static void genIndexTransRestr(std::vector<Transistor>& transistors, std::vector<Restriction>& restrictions,
-            std::vector<unsigned>& result);
+    static void genAdjacency(std::vector<Transistor>& transistors, std::vector<Restriction>& restrictions,
+            Adjacency& result);
+
+    static void genRestrictionStore(std::vector<Restriction>& restrictions, RestrictionStore& result);
+
+    static void genDomainTable(std::vector<std::vector<int>>& frecs, std::vector<Transistor>& transistors,
+            DomainTable& result);
 };
 
 
@@ -9,38 +9,62 @@
 
 #include "Poblacion.hpp"
 
+#include <algorithm>
+
 /**
  * @brief Default Constructor
  *
  * Generates a new population
- * @param [in]	transistors	 		vector with the transistors that conform the population
+ * @param [in]	domains		 		frequencies available to each transistor of the population
  * @param [in]	restrictions	 	vector with the restrictions that rules the ppopulation
- * @param [in] 	indxTransRestr   	Indice que indica la posición de cada transistor en el conjunto de restricciones
+ * @param [in] 	adjacency   		Restrictions incident to each transistor
+ * @param [in] 	semilla   			Seed of the random number generator of the population
+ * @param [in] 	hilos   			Threads used to evaluate the children, 0 uses every hardware thread
  */
 
-Poblacion::Poblacion(std::vector<Transistor>* transistors, 
-        std::vector<Restriction>* restrictions, 
-        std::vector<unsigned>* indxTransRestr)    : transistors_(transistors),
-        restrictions_(restrictions), indxTransRestr_(indxTransRestr)
+Poblacion::Poblacion(DomainTable* domains, 
+        RestrictionStore* restrictions, 
+        Adjacency* adjacency,
+        uint64_t semilla,
+        unsigned hilos)    : domains_(domains),
+        restrictions_(restrictions), adjacency_(adjacency), rng_(semilla)
 {
+    presupuesto_.setTamEvaluacion(restrictions_->size());
+    progreso_ = nullptr;
+    traza_ = nullptr;
+    isla_ = 0;
+    generacion_ = 0;
+    checkpoint_ = nullptr;
     mejor_ = 0;
     mundo_ = new std::vector<Especimen>;
+    pool_ = new ThreadPool(hilos);
+    elite_ = nullptr;
 }
 
 
 /**
  * @brief Copy Constructor
  *
- * Generates a new copy of a given population
+ * Generates a new copy of a given population. The copy starts with the counters of the
+ * original but its individuals charge their evaluations to its own budget
  * @param [in]	orig	Original population to copy
  */
 
 Poblacion::Poblacion(const Poblacion& orig)     :
-		transistors_(orig.transistors_), restrictions_(orig.restrictions_),
-		indxTransRestr_(orig.indxTransRestr_),  mejor_(orig.mejor_)
+		domains_(orig.domains_), restrictions_(orig.restrictions_),
+		adjacency_(orig.adjacency_), mejor_(orig.mejor_), rng_(orig.rng_), presupuesto_(orig.presupuesto_),
+		progreso_(orig.progreso_), traza_(orig.traza_), isla_(orig.isla_), generacion_(orig.generacion_),
+		checkpoint_(orig.checkpoint_)
 {
     mundo_ = new std::vector<Especimen>;
-    *mundo_ = *orig.mundo_;
+    prepararGenoma(orig.mundo_->size());
+    for(unsigned i = 0; i < orig.mundo_->size(); ++i)
+    {
+        mundo_->emplace_back( (*orig.mundo_)[i], fila(i) );
+        mundo_->back().setBudget(&presupuesto_);
+    }
+    pool_ = new ThreadPool(orig.pool_->getHilos());
+    elite_ = nullptr;
 }
 
 
@@ -53,6 +77,75 @@ Poblacion::Poblacion(const Poblacion& orig)     :
 Poblacion::~Poblacion() 
 {
     delete mundo_;
+    delete pool_;
+    delete elite_;
+}
+
+
+/**
+ * @brief Gets the row of the population genome where the genes of an individual are stored
+ *
+ * @param [in]	individuo		position of the individual in the population
+ * @return pointer to the first gene of the row
+ */
+
+int* Poblacion::fila(unsigned individuo)
+{
+    return genoma_.data() + (size_t)individuo * 2 * domains_->numTransistors();
+}
+
+
+/**
+ * @brief Makes room in the population genome for a number of individuals
+ *
+ * When the genome has to grow it is allocated again in a single block and the current
+ * individuals are moved to their rows of the new block.
+ *
+ * @param [in]	nIndividuos		number of individuals the genome must hold
+ */
+
+void Poblacion::prepararGenoma(unsigned nIndividuos)
+{
+    size_t tamFila = 2 * (size_t)domains_->numTransistors();
+    if (genoma_.size() >= nIndividuos * tamFila)
+        return;
+    
+    std::vector<int> nuevo(nIndividuos * tamFila);
+    for (unsigned i = 0; i < mundo_->size(); ++i)
+        (*mundo_)[i].reubicar(nuevo.data() + i * tamFila);
+    genoma_.swap(nuevo);
+    mundo_->reserve(nIndividuos);
+}
+
+
+/**
+ * @brief Evaluates some individuals, taking from the cache the ones already evaluated
+ *
+ * The cache is only read and written by the calling thread, the individuals that are not
+ * in it are evaluated in parallel, incrementally from the genes changed since their last
+ * evaluation.
+ *
+ * @param [in]	individuos		vector with the individuals
+ * @param [in]	indices			positions of the individuals to evaluate, overwritten with the ones not found
+ */
+
+void Poblacion::evaluarConCache(std::vector<Especimen>& individuos, std::vector<int>& indices)
+{
+    unsigned nuevos = 0;
+    for (unsigned i = 0; i < indices.size(); ++i)
+    {
+        int interferencia;
+        if (cache_.buscar(individuos[ indices[i] ].getHash(), interferencia))
+            individuos[ indices[i] ].setInterference(interferencia);
+        else
+            indices[nuevos++] = indices[i];
+    }
+    indices.resize(nuevos);
+    
+    pool_->parallelFor(nuevos, [&](unsigned i) { individuos[ indices[i] ].evaluateDelta(); });
+    
+    for (unsigned i = 0; i < nuevos; ++i)
+        cache_.guardar(individuos[ indices[i] ].getHash(), individuos[ indices[i] ].getInterference());
 }
 
 
@@ -64,12 +157,10 @@ Poblacion::~Poblacion()
 
 void Poblacion::iniciarPoblacion(int nIndividuos)
 {
-//    int vMejor = INT_MAX;
+    unsigned primero = mundo_->size();
+    prepararGenoma(primero + nIndividuos);
     for(int i = 0; i < nIndividuos; ++i)
-    {
-        Especimen nuevoEsp( transistors_ , restrictions_, indxTransRestr_);
-        mundo_->push_back(nuevoEsp);
-    }
+        mundo_->emplace_back( domains_ , restrictions_, adjacency_, rng_, fila(primero + i), &presupuesto_ );
     actualizarMejor();
 }
 
@@ -77,6 +168,10 @@ void Poblacion::iniciarPoblacion(int nIndividuos)
 /**
  * @brief Evolves population using a generational model
  *
+ * The children are built in place over the population, only the best individual is
+ * copied aside for the elitism. The work vectors are members, so once they have
+ * grown a generation does not allocate memory.
+ *
  * @param [in]	probabilidad  Cross probability
  * @param [in]	tipoCruce     Cross type to use, 0 = BLX 1 = 2 Points
  * @param [in]	pMutacion     Mutation probability
@@ -84,12 +179,6 @@ void Poblacion::iniciarPoblacion(int nIndividuos)
 
 void Poblacion::evolucionGeneracional(double probabilidad, int tipoCruce, double pMutacion)
 {
-    // Inicializamos hijos y lista de candidatos
-    std::vector<Especimen>* hijos = new std::vector<Especimen>;
-    *hijos = *mundo_;
-    
-    std::vector<int> candidatos;
-    
     // Calculamos esperanza Matematica
     int numCandidatos = (int)(mundo_->size()*probabilidad);
     int mutados = (int)(mundo_->size()*pMutacion);
@@ -99,15 +188,23 @@ void Poblacion::evolucionGeneracional(double probabilidad, int tipoCruce, double
     
     if(numCandidatos%2 != 0) ++numCandidatos;
     
+    // Guardamos el mejor para el elitismo, los hijos sustituyen a los padres en su sitio
+    if(!elite_)
+        elite_ = new Especimen( (*mundo_)[mejor_] );
+    else
+        *elite_ = (*mundo_)[mejor_];
+    std::vector<Especimen>& hijos = *mundo_;
+    std::vector<int>& candidatos = candidatos_;
+    candidatos.clear();
+    
     // Seleccionamos por Torneo Binario
-    candidatos.reserve(numCandidatos);
     for(int i = 0; i < numCandidatos; ++i)
     {
-        int candidato1 = getRandomInt(0, mundo_->size()-1);
-        int candidato2 = getRandomInt(0, mundo_->size()-1);
+        int candidato1 = rng_.getInt(0, mundo_->size()-1);
+        int candidato2 = rng_.getInt(0, mundo_->size()-1);
         
         while (candidato1 == candidato2)
-            candidato2 = getRandomInt(0, mundo_->size()-1);
+            candidato2 = rng_.getInt(0, mundo_->size()-1);
         
         if( (*mundo_)[candidato1].getInterference() < (*mundo_)[candidato2].getInterference() )
             candidatos.push_back( candidato1 );
@@ -118,54 +215,49 @@ void Poblacion::evolucionGeneracional(double probabilidad, int tipoCruce, double
     // Cruzamos los candidatos
     for (int i = 0; i < numCandidatos; i +=2 )
         if(tipoCruce == 0)
-            cruceBlx( (*hijos) [ candidatos[i] ] , (*hijos) [ candidatos[i+1] ] );
+            cruceBlx( hijos [ candidatos[i] ] , hijos [ candidatos[i+1] ], rng_ );
         else if (tipoCruce == 1)
-            cruce2Puntos( (*hijos) [ candidatos[i] ] , (*hijos) [ candidatos[i+1] ] );
+            cruce2Puntos( hijos [ candidatos[i] ] , hijos [ candidatos[i+1] ], rng_ );
     
-    // Evaluamos los que Hayamos cruzado
-    for(int i = 0; i < numCandidatos; ++i)
-    {
-        // Comprobamos que no lo hayamos evaluado antes ya que puede haberse cruzado 2 veces
-        bool evaluado = false;
-        for (int j = i-1; j >= 0; --j)
-            if(candidatos[i] == candidatos[j])
-            {
-                evaluado = true;
-                break;
-            }
-        
-        if(!evaluado)
-            (*hijos)[ candidatos[i] ].evaluate();
-        
-    }
-    
-    // Mutacion: Mutamos y evaluamos los mutados
+    // Mutacion: la evaluacion no interviene en el cruce ni en la mutacion, asi que
+    // los hijos se evaluan todos juntos despues
     for (int i = 0; i < mutados; ++i)
     {
-        int mutado = getRandomInt(0, hijos->size());
-        mutar( (*hijos)[mutado] );
-        (*hijos)[mutado].evaluate();
+        int mutado = rng_.getInt(0, hijos.size()-1);
+        mutar( hijos[mutado], rng_ );
+        candidatos.push_back(mutado);
     }
     
+    // Evaluamos en paralelo los que hayamos cruzado o mutado, una sola vez cada uno
+    // ya que pueden haberse cruzado o mutado varias veces
+    std::vector<char>& pendiente = marcas_;
+    std::vector<int>& evaluar = evaluar_;
+    pendiente.assign(hijos.size(), 0);
+    evaluar.clear();
+    for (unsigned i = 0; i < candidatos.size(); ++i)
+        if (!pendiente[ candidatos[i] ])
+        {
+            pendiente[ candidatos[i] ] = 1;
+            evaluar.push_back( candidatos[i] );
+        }
+    
+    evaluarConCache(hijos, evaluar);
+    
     // Elitismo: Si el mejor ha sido reemplazado la sustituimos por el peor de los hijos
-    if( (*mundo_)[mejor_] != (*hijos)[mejor_] ) 
+    if( *elite_ != hijos[mejor_] ) 
     {
         int peor = 0;
-        int vPeor = (*hijos)[0].getInterference();
-        for(unsigned i = 1; i < hijos->size(); ++i)
-            if( vPeor < (*hijos)[i].getInterference() )
+        int vPeor = hijos[0].getInterference();
+        for(unsigned i = 1; i < hijos.size(); ++i)
+            if( vPeor < hijos[i].getInterference() )
             {
-                vPeor = (*hijos)[i].getInterference();
+                vPeor = hijos[i].getInterference();
                 peor = i;
             }
 
-        (*hijos)[peor] = (*mundo_)[mejor_];
+        hijos[peor] = *elite_;
     }
     
-    // Reemplazamos
-    delete mundo_;
-    mundo_ = hijos;
-    
     // Calculamos y actualizamos el mejor
     int mejor = 0;
     int vMejor = (*mundo_)[0].getInterference();
@@ -177,6 +269,8 @@ void Poblacion::evolucionGeneracional(double probabilidad, int tipoCruce, double
         }
     
     mejor_ = mejor;
+    anunciarMejor();
+    registrarTraza();
 //    (*mundo_)[mejor].evaluate();
 }
 
@@ -191,47 +285,55 @@ void Poblacion::evolucionGeneracional(double probabilidad, int tipoCruce, double
 
 void Poblacion::evolucionEstacionaria(int tipoCruce, double pMutacion, int parejas) 
 {
-    // Inicializamos hijos
-    std::vector<Especimen> hijos;
+    // Inicializamos hijos, reutilizando los de la llamada anterior
+    std::vector<Especimen>& hijos = hijos_;
+    unsigned nHijos = parejas*2;
     
     // Seleccionamos hijos al azar
-    for(int i = 0; i < parejas*2; ++i)
+    for(unsigned i = 0; i < nHijos; ++i)
     {
-        int candidato = getRandomInt(0, mundo_->size()-1);
-        hijos.push_back( (*mundo_)[candidato] );
+        int candidato = rng_.getInt(0, mundo_->size()-1);
+        if (i < hijos.size())
+            hijos[i] = (*mundo_)[candidato];
+        else
+            hijos.push_back( (*mundo_)[candidato] );
     }
     
     // Cruzamos los candidatos
-    for (unsigned i = 0; i < hijos.size(); i +=2 )
+    for (unsigned i = 0; i < nHijos; i +=2 )
         if(tipoCruce == 0)
-            cruceBlx( hijos [i] , hijos [i+1] );
+            cruceBlx( hijos [i] , hijos [i+1], rng_ );
         else if (tipoCruce == 1)
-            cruce2Puntos( hijos [i] , hijos [i+1] );
+            cruce2Puntos( hijos [i] , hijos [i+1], rng_ );
     
     // Mutamos los hijos
-    for(unsigned i = 0; i < hijos.size(); ++i)
-        if( (double)( rand() / RAND_MAX ) <= pMutacion) 
-            mutar(hijos[i]);
+    for(unsigned i = 0; i < nHijos; ++i)
+        if( rng_.getDouble() < pMutacion) 
+            mutar(hijos[i], rng_);
 
     
     // Evaluamos
-    for (unsigned i = 0; i < hijos.size(); ++i)
-        hijos[i].evaluate();
+    std::vector<int>& evaluar = evaluar_;
+    evaluar.clear();
+    for(unsigned i = 0; i < nHijos; ++i)
+        evaluar.push_back(i);
+    evaluarConCache(hijos, evaluar);
     
     // Buscamos los N peores y reemplazamos
-    std::set<int> vistos;
-    for(unsigned i = 0; i < hijos.size(); ++i)
+    std::vector<char>& vistos = marcas_;
+    vistos.assign(mundo_->size(), 0);
+    for(unsigned i = 0; i < nHijos; ++i)
     { 
         int peor = 0;
         int vPeor = -1;
         for(unsigned j = 0; j < mundo_->size(); ++j)
-            if( vPeor < hijos[j].getInterference() && vistos.find(j) == vistos.end())
+            if( vPeor < (*mundo_)[j].getInterference() && !vistos[j])
             {
-                vPeor = hijos[j].getInterference();
+                vPeor = (*mundo_)[j].getInterference();
                 peor = j;
             }
         
-        vistos.insert(peor);
+        vistos[peor] = 1;
         
         // Comprobamos si es el mejor hasta el momento y si lo es lo colocamos en
         // el sitio que este piensa ocupar. El del que antes era el peor
@@ -241,7 +343,8 @@ void Poblacion::evolucionEstacionaria(int tipoCruce, double pMutacion, int parej
         if((*mundo_)[peor].getInterference() > hijos[i].getInterference())
             (*mundo_)[peor] = hijos[i];
     }
-    
+    anunciarMejor();
+    registrarTraza();
 }
 
 
@@ -252,12 +355,23 @@ void Poblacion::evolucionEstacionaria(int tipoCruce, double pMutacion, int parej
  */
 
 bool Poblacion::comprobarRepetidos(){
-    std::map<Especimen,int> arbol;
-    for(Especimen caso:*mundo_){
-        std::pair<Especimen,int> nodo(caso,0);
-        auto iterador=arbol.insert(nodo);
-        ++(iterador.first->second);
-        if(iterador.first->second >= mundo_->size()*0.8)           
+    // Tabla hash de direccionamiento abierto con al menos el doble de huecos que individuos
+    unsigned tam = 1;
+    while(tam < 2*mundo_->size())
+        tam <<= 1;
+    tablaRepetidos_.assign(tam, -1);
+    cuentaRepetidos_.assign(tam, 0);
+    
+    for(unsigned i = 0; i < mundo_->size(); ++i){
+        // Solo se comparan los genes si coinciden los hashes
+        unsigned hueco = (*mundo_)[i].getHash() & (tam-1);
+        while(tablaRepetidos_[hueco] != -1 && (*mundo_)[ tablaRepetidos_[hueco] ] != (*mundo_)[i])
+            hueco = (hueco+1) & (tam-1);
+        
+        if(tablaRepetidos_[hueco] == -1)
+            tablaRepetidos_[hueco] = i;
+        ++cuentaRepetidos_[hueco];
+        if(cuentaRepetidos_[hueco] >= mundo_->size()*0.8)
             return true;
     }
     return false;
@@ -276,24 +390,24 @@ void Poblacion::reinicializar(){
     mundo_->clear();
     
     mejor_=0;
-    (*mundo_).push_back(ejemplar);
+    mundo_->emplace_back(ejemplar, fila(0));
     
     int vMejor=ejemplar.getInterference();
     for(int i = 1; i < nIndividuos; ++i)
     {
-        Especimen nuevoEsp( transistors_ , restrictions_, indxTransRestr_);
-        mundo_->push_back(nuevoEsp);
-        if(vMejor > nuevoEsp.getInterference())
+        mundo_->emplace_back( domains_ , restrictions_, adjacency_, rng_, fila(i), &presupuesto_ );
+        if(vMejor > mundo_->back().getInterference())
         {   
             mejor_ = i;
-            vMejor = nuevoEsp.getInterference();
+            vMejor = mundo_->back().getInterference();
         }
     }
+    anunciarMejor();
 }
 
 
 /**
- * @brief Gets the best individual of the population
+ * @brief Gets a copy of the best individual of the population
  *
  * @return Especimen
  */
@@ -304,6 +418,18 @@ Especimen Poblacion::getMejor()
 }
 
 
+/**
+ * @brief Gets the interference of the best individual of the population, without copying it
+ *
+ * @return interference
+ */
+
+int Poblacion::getMejorInterferencia() const
+{
+    return (*mundo_)[mejor_].getInterference();
+}
+
+
 /**
  * @brief Updates the best candidate of the population
  *
@@ -322,5 +448,249 @@ void Poblacion::actualizarMejor()
         }
     
     mejor_ = mejor;
+    anunciarMejor();
 }
 
+
+/**
+ * @brief Replaces the worst individual of the population by an individual coming from another population
+ *
+ * @param [in]	inmigrante	individual that joins the population
+ */
+
+void Poblacion::recibirInmigrante(const Especimen& inmigrante)
+{
+    int peor = 0;
+    for(unsigned i = 1; i < mundo_->size(); ++i)
+        if( (*mundo_)[peor].getInterference() < (*mundo_)[i].getInterference() )
+            peor = i;
+
+    if( (*mundo_)[peor].getInterference() <= inmigrante.getInterference() )
+        return;
+
+    (*mundo_)[peor] = inmigrante;
+    if( (*mundo_)[mejor_].getInterference() > inmigrante.getInterference() )
+    {
+        mejor_ = peor;
+        anunciarMejor();
+    }
+}
+
+
+/**
+ * @brief Changes the number of threads used to evaluate the children of a generation
+ *
+ * @param [in]	hilos	number of threads, 0 uses every hardware thread
+ */
+
+void Poblacion::setHilos(unsigned hilos)
+{
+    delete pool_;
+    pool_ = new ThreadPool(hilos);
+}
+
+
+/**
+ * @brief Gets the random number generator of the population
+ *
+ * @return reference to the generator, so it can be reseeded or split
+ */
+
+RandomGenerator& Poblacion::getGenerador()
+{
+    return rng_;
+}
+
+
+/**
+ * @brief Gets the budget charged with the evaluations of the population
+ *
+ * @return reference to the budget, where the drivers read the evaluations made and the deadline
+ */
+
+Budget& Poblacion::getBudget()
+{
+    return presupuesto_;
+}
+
+
+/**
+ * @brief Sets where the changes of the best individual are reported
+ *
+ * Copies of the population, like the islands of the island model, report to the same place.
+ * @param [in]	progreso	reporter of the best assignment found, null to not report
+ */
+
+void Poblacion::setProgreso(ProgressReporter* progreso)
+{
+    progreso_ = progreso;
+    anunciarMejor();
+}
+
+
+/**
+ * @brief Gets the reporter of the best assignment
+ *
+ * @return reporter, null if there is none
+ */
+
+ProgressReporter* Poblacion::getProgreso()
+{
+    return progreso_;
+}
+
+
+/**
+ * @brief Tells the reporter, if there is one, about the current best individual
+ *
+ */
+
+void Poblacion::anunciarMejor()
+{
+    if (progreso_ && !mundo_->empty())
+        progreso_->mejora((*mundo_)[mejor_], presupuesto_);
+}
+
+
+/**
+ * @brief Sets the trace where the state of the population is recorded after each generation
+ *
+ * @param [in]	traza	convergence trace, null to disable it
+ */
+
+void Poblacion::setTraza(Trace* traza)
+{
+    traza_ = traza;
+}
+
+
+/**
+ * @brief Sets the island of the population, to tell its records apart in the trace
+ *
+ * @param [in]	isla	number of the island
+ */
+
+void Poblacion::setIsla(unsigned isla)
+{
+    isla_ = isla;
+}
+
+
+/**
+ * @brief Sets where the drivers save the search
+ *
+ * @param [in]	checkpoint	checkpoint of the search, null to not save it
+ */
+
+void Poblacion::setCheckpoint(Checkpoint* checkpoint)
+{
+    checkpoint_ = checkpoint;
+}
+
+
+/**
+ * @brief Gets where the drivers save the search
+ *
+ * @return checkpoint of the search, null if it is not saved
+ */
+
+Checkpoint* Poblacion::getCheckpoint()
+{
+    return checkpoint_;
+}
+
+
+/**
+ * @brief Writes the complete state of the population to a checkpoint
+ *
+ * Everything that decides the rest of the search is kept: the individuals with their
+ * pending changes, the best one, the random number generator, the budget and the cache,
+ * whose hits change the evaluations charged.
+ * @param [in,out]	estado	checkpoint being written
+ */
+
+void Poblacion::guardarEstado(BinaryWriter& estado) const
+{
+    estado.valor(domains_->numTransistors());
+    estado.valor(restrictions_->size());
+    estado.valor((uint64_t)mundo_->size());
+    for (unsigned i = 0; i < mundo_->size(); ++i)
+        (*mundo_)[i].guardarEstado(estado);
+    estado.valor(mejor_);
+    estado.valor(rng_);
+    estado.valor(generacion_);
+    presupuesto_.guardarEstado(estado);
+    cache_.guardarEstado(estado);
+}
+
+
+/**
+ * @brief Replaces the state of the population by the one written to a checkpoint
+ *
+ * @param [in,out]	estado	checkpoint being read
+ */
+
+void Poblacion::cargarEstado(BinaryReader& estado)
+{
+    if (estado.valor<unsigned>() != domains_->numTransistors()
+            || estado.valor<unsigned>() != restrictions_->size())
+        throw std::runtime_error("The checkpoint is of another instance");
+
+    unsigned nIndividuos = estado.valor<uint64_t>();
+    mundo_->clear();
+    prepararGenoma(nIndividuos);
+    for (unsigned i = 0; i < nIndividuos; ++i)
+        mundo_->emplace_back( domains_, restrictions_, adjacency_, estado, fila(i), &presupuesto_ );
+    mejor_ = estado.valor<int>();
+    if (mejor_ < 0 || (unsigned)mejor_ >= nIndividuos)
+        throw std::runtime_error("Wrong best individual in the checkpoint");
+    rng_ = estado.valor<RandomGenerator>();
+    generacion_ = estado.valor<uint64_t>();
+    presupuesto_.cargarEstado(estado);
+    cache_.cargarEstado(estado);
+    anunciarMejor();
+}
+
+
+/**
+ * @brief Counts a generation and, if the trace is enabled, records the state of the population
+ *
+ * The diversity is the fraction of individuals whose hash no other individual has.
+ */
+
+void Poblacion::registrarTraza()
+{
+    ++generacion_;
+    if (!traza_ || mundo_->empty())
+        return;
+
+    Trace::Registro registro;
+    registro.isla = isla_;
+    registro.generacion = generacion_;
+    registro.segundos = presupuesto_.getSegundos();
+    registro.evaluaciones = presupuesto_.getEvaluaciones();
+    registro.mejor = (*mundo_)[mejor_].getInterference();
+    registro.peor = registro.mejor;
+
+    double suma = 0;
+    hashesTraza_.resize(mundo_->size());
+    for (unsigned i = 0; i < mundo_->size(); ++i)
+    {
+        int interferencia = (*mundo_)[i].getInterference();
+        suma += interferencia;
+        if (registro.peor < interferencia)
+            registro.peor = interferencia;
+        hashesTraza_[i] = (*mundo_)[i].getHash();
+    }
+    registro.media = suma / mundo_->size();
+
+    std::sort(hashesTraza_.begin(), hashesTraza_.end());
+    unsigned unicos = 0;
+    for (unsigned i = 0; i < hashesTraza_.size(); ++i)
+        if ((i == 0 || hashesTraza_[i] != hashesTraza_[i-1])
+                && (i + 1 == hashesTraza_.size() || hashesTraza_[i] != hashesTraza_[i+1]))
+            ++unicos;
+    registro.diversidad = (double)unicos / mundo_->size();
+
+    traza_->registrar(registro);
+}
@@ -12,11 +12,18 @@
 
 #include "Especimen.hpp"
 #include "Random.hpp"
+#include "ThreadPool.hpp"
+#include "FitnessCache.hpp"
+#include "Budget.hpp"
+#include "ProgressReporter.hpp"
+#include "Trace.hpp"
+#include "BinaryStream.hpp"
 #include <vector>
 #include <list>
-#include <map>
 #include <set>
 
+class Checkpoint;
+
 /**
  * @brief Class Poblacion, managing a set of individuals
  *
@@ -25,9 +32,11 @@
 class Poblacion {
 public:
     Poblacion(
-            std::vector<Transistor>* transistors, 
-            std::vector<Restriction>* restrictions, 
-            std::vector<unsigned>* indxTransRestr
+            DomainTable* domains, 
+            RestrictionStore* restrictions, 
+            Adjacency* adjacency,
+            uint64_t semilla,
+            unsigned hilos = 0
             );
     
     Poblacion(const Poblacion& orig);
@@ -36,31 +45,75 @@ public:
     void evolucionEstacionaria(int tipoCruce, double pMutacion = 0.1, int parejas = 1);
     void evolucionGeneracional(double probabilidad, int tipoCruce, double pMutacion = 0.1);
     
-    friend int am1010(int nIndividuos, int evaluaciones,Poblacion& entorno, double cruce, int tipo, double mutacion);
+    friend int am1010(int nIndividuos, int evaluaciones,Poblacion& entorno, double cruce, int tipo, double mutacion,
+            int busqueda);
 
-    friend int am1001(int nIndividuos, int evaluaciones,Poblacion& entorno, double cruce, int tipo, double mutacion);
+    friend int am1001(int nIndividuos, int evaluaciones,Poblacion& entorno, double cruce, int tipo, double mutacion,
+            int busqueda);
 
-    friend int am1001Mej(int nIndividuos, int evaluaciones,Poblacion& entorno, double cruce, int tipo, double mutacion);
+    friend int am1001Mej(int nIndividuos, int evaluaciones,Poblacion& entorno, double cruce, int tipo, double mutacion,
+            int busqueda);
+    
+    friend int algoritmoTabu(int evaluaciones, Poblacion& entorno);
     
     bool comprobarRepetidos();
     
     void actualizarMejor();
     void reinicializar();
+    void recibirInmigrante(const Especimen& inmigrante);
+    void setHilos(unsigned hilos);
+    RandomGenerator& getGenerador();
+    Budget& getBudget();
+    void setProgreso(ProgressReporter* progreso);
+    ProgressReporter* getProgreso();
+    void setTraza(Trace* traza);
+    void setIsla(unsigned isla);
+    void setCheckpoint(Checkpoint* checkpoint);
+    Checkpoint* getCheckpoint();
+    
+    void guardarEstado(BinaryWriter& estado) const;
+    void cargarEstado(BinaryReader& estado);
     
     Especimen getMejor();
+    int getMejorInterferencia() const;
     
     virtual ~Poblacion();
     
     
 private:
     
-    std::vector<Transistor>* 	transistors_;           ///< Vector with the transistors of the individual
-    std::vector<Restriction>* 	restrictions_;          ///< Vector with the restrictions that the individual will have to consider
-    std::vector<unsigned>* 		indxTransRestr_;        ///< Indexes of the restrictions that we will have to be taken into account
+    DomainTable* 				domains_;               ///< Frequencies available to each transistor
+    RestrictionStore* 			restrictions_;          ///< Vector with the restrictions that the individual will have to consider
+    Adjacency* 					adjacency_;             ///< Restrictions incident to each transistor
 
     std::vector<Especimen>* 	mundo_;					///< Vector with the individuals of the population
+    std::vector<int>			genoma_;				///< Genes of every individual, one row of 2 ints per transistor each
+    ThreadPool*					pool_;					///< Threads used to evaluate the children of a generation
 
     int mejor_;											///< Index to keep track of the best individual
+    RandomGenerator				rng_;					///< Random number generator of the population
+    Budget						presupuesto_;			///< Evaluations made by the individuals of the population
+    ProgressReporter*			progreso_;				///< Told about every change of the best individual, may be null
+    Trace*						traza_;					///< Convergence trace, null when it is disabled
+    unsigned					isla_;					///< Island of the population in the trace
+    uint64_t					generacion_;			///< Generations made by the population
+    std::vector<uint64_t>		hashesTraza_;			///< Hashes of the individuals, reused to measure the diversity
+    Checkpoint*					checkpoint_;			///< Where the drivers save the search, null to not save it
+
+    int* fila(unsigned individuo);
+    void prepararGenoma(unsigned nIndividuos);
+    void evaluarConCache(std::vector<Especimen>& individuos, std::vector<int>& indices);
+    void anunciarMejor();
+    void registrarTraza();
+
+    Especimen*					elite_;					///< Copy of the best individual kept while a generation is built
+    std::vector<Especimen>		hijos_;					///< Children of the steady one model, reused between calls
+    std::vector<int>			candidatos_;			///< Individuals selected, crossed or mutated in the current generation
+    std::vector<int>			evaluar_;				///< Individuals to be evaluated in the current generation
+    std::vector<char>			marcas_;				///< Per individual flag, reused between generations
+    FitnessCache				cache_;					///< Interference of recently evaluated individuals
+    std::vector<int>			tablaRepetidos_;		///< Open addressing table of comprobarRepetidos, reused between calls
+    std::vector<int>			cuentaRepetidos_;		///< Copies of the individual in each slot of tablaRepetidos_
     
     
     
@@ -0,0 +1,135 @@
+/**
+ * @file ProgressReporter.cpp
+ * @brief Sources for the class ProgressReporter
+ *
+ */
+
+#include "ProgressReporter.hpp"
+
+#include <fstream>
+
+/**
+ * @brief Default constructor, no assignment found yet
+ *
+ * @param [in]	salida	stream where each improvement is written, null to only keep the best one
+ */
+
+ProgressReporter::ProgressReporter(std::ostream* salida) : salida_(salida), interferencia_(INT_MAX),
+        total_(nullptr), transistores_(nullptr)
+{
+}
+
+
+/**
+ * @brief Constructor of the reporter of a component of an instance
+ *
+ * @param [in]	total			reporter of the whole instance, which must already have an assignment
+ * @param [in]	transistores	transistor of the whole instance of each transistor of the component
+ * @param [in]	interferencia	interference of the component in the assignment of total, only
+ * 								the improvements over it are passed on
+ */
+
+ProgressReporter::ProgressReporter(ProgressReporter* total, const std::vector<unsigned>* transistores,
+        int interferencia) : salida_(nullptr), interferencia_(interferencia), total_(total),
+        transistores_(transistores)
+{
+}
+
+
+/**
+ * @brief Receives the best individual of a population
+ *
+ * Most calls do not improve anything and only read an atomic value; the copy of the
+ * assignment and the output are done under the lock.
+ *
+ * @param [in]	mejor			best individual of the population
+ * @param [in]	presupuesto		budget of the population, for the time and evaluations used
+ */
+
+void ProgressReporter::mejora(const Especimen& mejor, const Budget& presupuesto)
+{
+    int interferencia = mejor.getInterference();
+    if (interferencia >= interferencia_.load(std::memory_order_relaxed))
+        return;
+
+    std::lock_guard<std::mutex> lock(cerrojo_);
+    if (interferencia >= interferencia_.load(std::memory_order_relaxed))
+        return;
+
+    int antes = interferencia_.load(std::memory_order_relaxed);
+    interferencia_.store(interferencia, std::memory_order_relaxed);
+    frecuencias_.resize(mejor.getSize());
+    for (unsigned i = 0; i < frecuencias_.size(); ++i)
+        frecuencias_[i] = mejor.getFrecuencia(i);
+
+    if (total_)
+        total_->sustituir(*transistores_, frecuencias_, antes, interferencia, presupuesto);
+
+    if (salida_)
+        *salida_ << interferencia << "\t" << presupuesto.getSegundos() << "\t"
+                << (long long)presupuesto.getEvaluaciones() << std::endl;
+}
+
+
+/**
+ * @brief Puts a better assignment of a component into the best assignment
+ *
+ * The restrictions of a component only join its own transistors, so the interference of the
+ * instance changes as much as the one of the component.
+ * @param [in]	transistores	transistor of the whole instance of each transistor of the component
+ * @param [in]	frecuencias		frequency of each transistor of the component
+ * @param [in]	antes			interference of the component in the best assignment
+ * @param [in]	despues			interference of the component with frecuencias
+ * @param [in]	presupuesto		budget of the component, for the time and evaluations used
+ */
+
+void ProgressReporter::sustituir(const std::vector<unsigned>& transistores, const std::vector<int>& frecuencias,
+        int antes, int despues, const Budget& presupuesto)
+{
+    std::lock_guard<std::mutex> lock(cerrojo_);
+    if (frecuencias_.empty())
+        return;
+
+    int interferencia = interferencia_.load(std::memory_order_relaxed) - antes + despues;
+    interferencia_.store(interferencia, std::memory_order_relaxed);
+    for (unsigned i = 0; i < transistores.size(); ++i)
+        frecuencias_[transistores[i]] = frecuencias[i];
+
+    if (salida_)
+        *salida_ << interferencia << "\t" << presupuesto.getSegundos() << "\t"
+                << (long long)presupuesto.getEvaluaciones() << std::endl;
+}
+
+
+/**
+ * @brief Gets the interference of the best assignment
+ *
+ * @return interference, INT_MAX if no assignment has been received
+ */
+
+int ProgressReporter::getInterferencia() const
+{
+    return interferencia_.load(std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief Writes the best assignment, one line "id frequency" per transistor
+ *
+ * @param [in]	path		path of the file
+ * @param [in]	domains		frequencies of the instance, for the ids of the transistors
+ * @return false if there is no assignment or the file could not be written
+ */
+
+bool ProgressReporter::escribirSolucion(const std::string& path, const DomainTable& domains) const
+{
+    std::lock_guard<std::mutex> lock(cerrojo_);
+    if (frecuencias_.empty())
+        return false;
+
+    std::ofstream file(path);
+    for (unsigned i = 0; i < frecuencias_.size() && file; ++i)
+        file << domains.transId[i] << " " << frecuencias_[i] << "\n";
+    file.close();
+    return !file.fail();
+}
@@ -0,0 +1,53 @@
+/**
+ * @file ProgressReporter.hpp
+ * @brief Headers declarations for class ProgressReporter
+ *
+ */
+
+#ifndef PROGRESSREPORTER_HPP
+#define PROGRESSREPORTER_HPP
+
+#include <atomic>
+#include <climits>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Especimen.hpp"
+#include "Budget.hpp"
+
+/**
+ * @brief Best assignment found so far by a search
+ *
+ * The populations tell it every time their best individual changes. Only the ones that
+ * improve the best interference seen are kept, and each of them can be written at once
+ * to a stream, so a run stopped at any moment still has its best assignment. The islands
+ * of the island model share the same reporter from their own threads. The populations of
+ * the components of an instance have a reporter each, which puts the improvements of its
+ * component into the assignment of the reporter of the whole instance.
+ */
+
+class ProgressReporter {
+public:
+    explicit ProgressReporter(std::ostream* salida = nullptr);
+    ProgressReporter(ProgressReporter* total, const std::vector<unsigned>* transistores, int interferencia);
+
+    void mejora(const Especimen& mejor, const Budget& presupuesto);
+
+    int getInterferencia() const;
+    bool escribirSolucion(const std::string& path, const DomainTable& domains) const;
+
+private:
+    void sustituir(const std::vector<unsigned>& transistores, const std::vector<int>& frecuencias,
+            int antes, int despues, const Budget& presupuesto);
+
+    std::ostream* salida_;					///< Where each improvement is written, null to not write them
+    std::atomic<int> interferencia_;		///< Interference of the best assignment, INT_MAX if there is none
+    std::vector<int> frecuencias_;			///< Frequency of each transistor in the best assignment
+    mutable std::mutex cerrojo_;			///< Protects the best assignment and the stream
+    ProgressReporter* total_;				///< Reporter of the whole instance if this one is the one of a component
+    const std::vector<unsigned>* transistores_;	///< Transistor of the whole instance of each one of the component
+};
+
+#endif /* PROGRESSREPORTER_HPP */
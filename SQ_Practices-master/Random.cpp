@@ -1,20 +1,125 @@
 /**
  * @file Random.cpp
- * @brief Sources for random function
+ * @brief Sources for the random number generator
  */
 
 #include "Random.hpp"
 
 /**
- * @brief Generates an integer within a range between two numbers(int) being both included
+ * @brief Step of the splitmix64 generator, used to expand a seed into a full state
+ *
+ * @param [in,out]	x	splitmix64 state
+ * @return next value of the sequence
+ */
+
+static uint64_t splitmix64(uint64_t& x)
+{
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+
+/**
+ * @brief Rotates a 64 bits word to the left
+ *
+ */
+
+static inline uint64_t rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+
+/**
+ * @brief Main constructor
+ *
+ * @param [in]	semilla		seed of the sequence
+ */
+
+RandomGenerator::RandomGenerator(uint64_t semilla)
+{
+    for (int i = 0; i < 4; ++i)
+        s_[i] = splitmix64(semilla);
+}
+
+
+/**
+ * @brief Generates the next 64 random bits
+ *
+ * @return random 64 bits word
+ */
+
+uint64_t RandomGenerator::next()
+{
+    uint64_t resultado = rotl(s_[1] * 5, 7) * 9;
+    uint64_t t = s_[1] << 17;
+
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = rotl(s_[3], 45);
+
+    return resultado;
+}
+
+
+/**
+ * @brief Generates an integer within a range between two numbers(int) being both included, without modulo bias
  *
  * @param [in]	inferior  Lower bound (closed interval)
  * @param [in]	superior  Upper bound (closed interval)
  * @return Random integer within the interval
  */
 
-int getRandomInt(int inferior, int superior){
-    int aleatorio= inferior + rand()%(superior-inferior);
-    return aleatorio;
-};
+int RandomGenerator::getInt(int inferior, int superior)
+{
+    uint64_t rango = (uint64_t)((int64_t)superior - inferior) + 1;
+
+    // Metodo de Lemire: se descartan los valores que introducirian sesgo
+    unsigned __int128 m = (unsigned __int128)next() * rango;
+    uint64_t bajo = (uint64_t)m;
+    if (bajo < rango)
+    {
+        uint64_t umbral = -rango % rango;
+        while (bajo < umbral)
+        {
+            m = (unsigned __int128)next() * rango;
+            bajo = (uint64_t)m;
+        }
+    }
+    return (int)((int64_t)inferior + (int64_t)(m >> 64));
+}
+
+
+/**
+ * @brief Generates a real number in [0, 1)
+ *
+ * @return Random double with 53 random bits
+ */
+
+double RandomGenerator::getDouble()
+{
+    return (next() >> 11) * 0x1.0p-53;
+}
+
+
+/**
+ * @brief Derives an independent generator, for instance one for each thread
+ *
+ * The result only depends on the current state and on flujo, so the same streams are
+ * obtained whatever the number of threads that will use them.
+ *
+ * @param [in]	flujo	number of the derived stream
+ * @return new generator
+ */
 
+RandomGenerator RandomGenerator::split(uint64_t flujo) const
+{
+    uint64_t x = s_[0] ^ rotl(s_[1], 13) ^ rotl(s_[2], 29) ^ rotl(s_[3], 47);
+    x ^= splitmix64(flujo);
+    return RandomGenerator(splitmix64(x));
+}
@@ -1,7 +1,7 @@
 /**
  * @file   Random.hpp
  * @author sobremesa
- * @brief headers files for random function
+ * @brief headers files for the random number generator
  *
  * Created on 12 November 2017, 12:34
  */
@@ -9,12 +9,28 @@
 #ifndef RANDOM_HPP
 #define RANDOM_HPP
 
-#include <iostream>
-#include <stdlib.h>
-#include <climits>
+#include <cstdint>
 
+/**
+ * @brief Seedable pseudo random number generator (xoshiro256**)
+ *
+ * There is no shared state: every population, or thread, owns its generator, so a
+ * run is reproducible for a given seed. split derives independent generators for
+ * parallel work without advancing the original one.
+ */
+
+class RandomGenerator {
+public:
+    explicit RandomGenerator(uint64_t semilla = 0);
+
+    uint64_t next();
+    int getInt(int inferior, int superior);
+    double getDouble();
+    RandomGenerator split(uint64_t flujo) const;
 
-int getRandomInt(int inferior, int superior);
+private:
+    uint64_t s_[4];		///< Generator state
+};
 
 
 #endif /* RANDOM_HPP */
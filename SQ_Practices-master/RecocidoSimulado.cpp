@@ -0,0 +1,200 @@
+/**
+ * @file RecocidoSimulado.cpp
+ * @brief Simulated annealing with several replicas at different temperatures (parallel tempering)
+ *
+ */
+
+#include "RecocidoSimulado.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+/**
+ * Moves sampled from the initial individual to set the temperatures
+ */
+static const int muestrasTemperatura = 200;
+
+/**
+ * Acceptance of the mean worsening move of the initial individual at the hottest and at the
+ * coldest temperature of the ladder
+ */
+static const double aceptacionCaliente = 0.5;
+static const double aceptacionFria = 0.001;
+
+
+/**
+ * @brief Chain of the annealing, with its own individual, budget and random number generator
+ *
+ * The replicas never move between temperatures: an exchange swaps their positions in the
+ * ladder instead, so the individuals are never copied.
+ */
+struct Replica
+{
+    std::unique_ptr<Especimen> actual;		///< Individual the chain is at
+    std::unique_ptr<Especimen> mejor;		///< Best individual of the chain, outdated while enMejor
+    bool enMejor;							///< Whether actual is the best individual of the chain
+    Budget presupuesto;						///< Evaluations made by the chain
+    RandomGenerator rng;					///< Random number generator of the chain
+    double fin;								///< Evaluations of presupuesto at which the chain stops, its share of the budget
+};
+
+
+/**
+ * @brief Runs a chain of the annealing at a fixed temperature
+ *
+ * Each move gives a random transistor another random frequency, and is accepted if it does
+ * not make the individual worse or, if it does by delta, with probability exp(-delta/T).
+ * @param [in,out]	replica			Chain
+ * @param [in]		temperatura		Temperature of the chain
+ * @param [in]		movimientos		Moves to try
+ */
+
+static void recocer(Replica& replica, double temperatura, int movimientos)
+{
+    Especimen& esp = *replica.actual;
+    int tam = esp.getSize();
+    for (int m = 0; m < movimientos; ++m)
+    {
+        if (m % Budget::movimientosComprobacion == 0 && !replica.presupuesto.queda(replica.fin))
+            return;
+
+        unsigned trans = replica.rng.getInt(0, tam - 1);
+        int rango = esp.getFreqRange(trans);
+        if (rango < 2)
+            continue;
+        int destino = (esp.getIndice(trans) + replica.rng.getInt(1, rango - 1)) % rango;
+        uint64_t comprobaciones = 0;
+        int delta = esp.deltaMovimiento(trans, destino, &comprobaciones);
+        if (esp.getBudget())
+            esp.getBudget()->contarParcial(comprobaciones);
+        if (delta > 0 && replica.rng.getDouble() >= std::exp(-delta / temperatura))
+            continue;
+
+        // El mejor solo se copia al salir de el
+        if (delta > 0 && replica.enMejor)
+        {
+            *replica.mejor = esp;
+            replica.enMejor = false;
+        }
+        esp.aplicarMovimiento(trans, destino, delta);
+        if (!replica.enMejor && esp.getInterference() < replica.mejor->getInterference())
+            replica.enMejor = true;
+    }
+}
+
+
+/**
+ * @brief Best individual found by a chain
+ *
+ * @param [in]	replica		Chain
+ * @return the individual
+ */
+
+static const Especimen& mejorReplica(const Replica& replica)
+{
+    return replica.enMejor ? *replica.actual : *replica.mejor;
+}
+
+
+/**
+ * @brief Parallel tempering: simulated annealing chains at a geometric ladder of temperatures that exchange their individuals
+ *
+ * Every chain starts from the best individual of the population and runs on its own thread,
+ * with its own budget and a random number generator split from the one of the population, so
+ * the result for a given seed does not depend on the threads. The evaluations are split evenly
+ * among the chains, so the model spends the same evaluations as the other ones. After each sweep of ten moves
+ * per transistor, neighbour temperatures of the ladder swap their individuals with the usual
+ * probability min(1, exp((E1 - E2)(1/T1 - 1/T2))), alternating even and odd pairs, and the best
+ * individual of each chain is offered to the population.
+ *
+ * The ladder goes from the temperature that accepts the mean worsening move of the initial
+ * individual half of the times to the one that accepts it once in a thousand.
+ * @param [in]		nReplicas			Number of chains, one thread each
+ * @param [in]		evaluaciones		Number of evaluations of all the chains together
+ * @param [in,out]	entorno				Population, initialized, that receives the best individual
+ * @return								The minimum interference calculated is returned
+ */
+
+int recocidoParalelo(int nReplicas, int evaluaciones, Poblacion& entorno)
+{
+    if (nReplicas <= 0)
+        nReplicas = 1;
+
+    // Temperaturas a partir del empeoramiento medio de movimientos al azar del individuo inicial
+    Especimen inicial = entorno.getMejor();
+    RandomGenerator& rng = entorno.getGenerador();
+    double empeoramiento = 0;
+    int empeoran = 0;
+    for (int i = 0; i < muestrasTemperatura; ++i)
+    {
+        unsigned trans = rng.getInt(0, inicial.getSize() - 1);
+        uint64_t comprobaciones = 0;
+        int delta = inicial.deltaMovimiento(trans, rng.getInt(0, inicial.getFreqRange(trans) - 1), &comprobaciones);
+        if (inicial.getBudget())
+            inicial.getBudget()->contarParcial(comprobaciones);
+        if (delta > 0)
+        {
+            empeoramiento += delta;
+            ++empeoran;
+        }
+    }
+    empeoramiento = empeoran ? empeoramiento / empeoran : 1;
+    double caliente = empeoramiento / -std::log(aceptacionCaliente);
+    double fria = empeoramiento / -std::log(aceptacionFria);
+
+    std::vector<double> temperaturas(nReplicas);
+    for (int k = 0; k < nReplicas; ++k)
+        temperaturas[k] = nReplicas > 1 ? fria * std::pow(caliente / fria, (double)k / (nReplicas - 1)) : fria;
+
+    std::vector<Replica> replicas(nReplicas);
+    std::vector<int> orden(nReplicas);
+    double cuota = (double)evaluaciones / nReplicas;
+    for (int i = 0; i < nReplicas; ++i)
+    {
+        Replica& replica = replicas[i];
+        replica.presupuesto = entorno.getBudget();
+        replica.presupuesto.reiniciarContadores();
+        replica.fin = cuota;
+        replica.rng = rng.split(i);
+        replica.actual.reset(new Especimen(inicial));
+        replica.actual->setBudget(&replica.presupuesto);
+        replica.mejor.reset(new Especimen(inicial));
+        replica.enMejor = true;
+        orden[i] = i;
+    }
+
+    int movimientos = 10 * inicial.getSize();
+    ThreadPool pool(nReplicas);
+    bool quedan = true;
+    for (int barrido = 0; quedan; ++barrido)
+    {
+        // orden[k] es la replica que esta a la temperatura k
+        pool.parallelFor(nReplicas, [&](unsigned k) {
+            recocer(replicas[orden[k]], temperaturas[k], movimientos);
+        });
+
+        quedan = false;
+        for (int i = 0; i < nReplicas; ++i)
+        {
+            entorno.recibirInmigrante(mejorReplica(replicas[i]));
+            if (replicas[i].presupuesto.queda(replicas[i].fin))
+                quedan = true;
+        }
+
+        for (int k = barrido % 2; k + 1 < nReplicas; k += 2)
+        {
+            double energia1 = replicas[orden[k]].actual->getInterference();
+            double energia2 = replicas[orden[k+1]].actual->getInterference();
+            double exponente = (energia1 - energia2) * (1 / temperaturas[k] - 1 / temperaturas[k+1]);
+            if (exponente >= 0 || rng.getDouble() < std::exp(exponente))
+                std::swap(orden[k], orden[k+1]);
+        }
+    }
+
+    for (int i = 0; i < nReplicas; ++i)
+        entorno.getBudget().sumar(replicas[i].presupuesto);
+    return entorno.getMejorInterferencia();
+}
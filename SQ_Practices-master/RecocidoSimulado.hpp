@@ -0,0 +1,14 @@
+/**
+ * @file RecocidoSimulado.hpp
+ * @brief Declaration of the parallel tempering simulated annealing
+ *
+ */
+
+#ifndef RECOCIDOSIMULADO_HPP
+#define RECOCIDOSIMULADO_HPP
+
+#include "Poblacion.hpp"
+
+int recocidoParalelo(int nReplicas, int evaluaciones, Poblacion& entorno);
+
+#endif /* RECOCIDOSIMULADO_HPP */
@@ -0,0 +1,182 @@
+/**
+ * @file RestrictionStore.cpp
+ * @brief Sources for the evaluation kernels over a RestrictionStore
+ *
+ * The AVX2 and SSE4.1 kernels are compiled with target attributes, so the rest of
+ * the program does not need special flags. The fastest kernel supported by the
+ * running CPU is chosen the first time an evaluation is requested. Building with
+ * -DSQ_CHECK_EVERY_ADD chooses instead the scalar kernel that checks every addition.
+ */
+
+#include "RestrictionStore.hpp"
+#include "OverflowPolicy.hpp"
+
+#include <cstdlib>
+
+// Las versiones SIMD solo se compilan si pueden elegirse
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(SQ_CHECK_EVERY_ADD)
+#define RESTRICTIONSTORE_X86
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Portable kernel, one restriction at a time
+ *
+ * @tparam Overflow	policy that accumulates the interference and detects an overflow
+ * @param [in]	rs		restrictions to evaluate
+ * @param [in]	freqs	frequency of every transistor
+ * @param [in]	begin	first restriction to evaluate
+ * @return sum of the interferences of the violated restrictions
+ */
+
+template <class Overflow>
+static long long evaluateScalar(const RestrictionStore& rs, const int* freqs, unsigned begin = 0)
+{
+    const int32_t* t1 = rs.trans1.data();
+    const int32_t* t2 = rs.trans2.data();
+    const int32_t* bound = rs.bound.data();
+    const int32_t* interf = rs.interference.data();
+
+    typename Overflow::Accumulator total = 0;
+    for (unsigned k = begin; k < rs.size(); ++k)
+        if ( bound[k] < std::abs(freqs[t1[k]] - freqs[t2[k]]) )
+            total = Overflow::add(total, interf[k]);
+    return total;
+}
+
+#ifdef RESTRICTIONSTORE_X86
+
+/**
+ * @brief SSE4.1 kernel, four restrictions at a time
+ *
+ * @param [in]	rs		restrictions to evaluate
+ * @param [in]	freqs	frequency of every transistor
+ * @return sum of the interferences of the violated restrictions
+ */
+
+__attribute__((target("sse4.1")))
+static long long evaluateSse41(const RestrictionStore& rs, const int* freqs)
+{
+    const int32_t* t1 = rs.trans1.data();
+    const int32_t* t2 = rs.trans2.data();
+    const int32_t* bound = rs.bound.data();
+    const int32_t* interf = rs.interference.data();
+
+    unsigned n = rs.size() & ~3u;
+    __m128i acc = _mm_setzero_si128();
+    for (unsigned k = 0; k < n; k += 4)
+    {
+        __m128i f1 = _mm_set_epi32(freqs[t1[k+3]], freqs[t1[k+2]], freqs[t1[k+1]], freqs[t1[k]]);
+        __m128i f2 = _mm_set_epi32(freqs[t2[k+3]], freqs[t2[k+2]], freqs[t2[k+1]], freqs[t2[k]]);
+        __m128i diff = _mm_abs_epi32(_mm_sub_epi32(f1, f2));
+        __m128i mask = _mm_cmpgt_epi32(diff, _mm_loadu_si128((const __m128i*)(bound + k)));
+        __m128i val = _mm_and_si128(mask, _mm_loadu_si128((const __m128i*)(interf + k)));
+
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(val));
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(val, 8)));
+    }
+
+    long long lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, acc);
+    return lanes[0] + lanes[1] + evaluateScalar<CheckedAtEnd>(rs, freqs, n);
+}
+
+
+/**
+ * @brief AVX2 kernel, eight restrictions at a time gathering the frequencies
+ *
+ * @param [in]	rs		restrictions to evaluate
+ * @param [in]	freqs	frequency of every transistor
+ * @return sum of the interferences of the violated restrictions
+ */
+
+__attribute__((target("avx2")))
+static long long evaluateAvx2(const RestrictionStore& rs, const int* freqs)
+{
+    const int32_t* t1 = rs.trans1.data();
+    const int32_t* t2 = rs.trans2.data();
+    const int32_t* bound = rs.bound.data();
+    const int32_t* interf = rs.interference.data();
+
+    unsigned n = rs.size() & ~7u;
+    __m256i acc = _mm256_setzero_si256();
+    for (unsigned k = 0; k < n; k += 8)
+    {
+        __m256i f1 = _mm256_i32gather_epi32(freqs, _mm256_loadu_si256((const __m256i*)(t1 + k)), 4);
+        __m256i f2 = _mm256_i32gather_epi32(freqs, _mm256_loadu_si256((const __m256i*)(t2 + k)), 4);
+        __m256i diff = _mm256_abs_epi32(_mm256_sub_epi32(f1, f2));
+        __m256i mask = _mm256_cmpgt_epi32(diff, _mm256_loadu_si256((const __m256i*)(bound + k)));
+        __m256i val = _mm256_and_si256(mask, _mm256_loadu_si256((const __m256i*)(interf + k)));
+
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(val)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(val, 1)));
+    }
+
+    long long lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + evaluateScalar<CheckedAtEnd>(rs, freqs, n);
+}
+
+#endif
+
+typedef long long (*EvaluateKernel)(const RestrictionStore&, const int*);
+
+/**
+ * @brief Chooses the fastest kernel supported by the running CPU
+ *
+ * @param [out]	name	name of the chosen kernel
+ * @return the chosen kernel
+ */
+
+static EvaluateKernel selectKernel(const char*& name)
+{
+#ifdef SQ_CHECK_EVERY_ADD
+    name = "scalar-checked";
+    return [](const RestrictionStore& rs, const int* freqs) { return evaluateScalar<CheckedPerAdd>(rs, freqs); };
+#else
+#ifdef RESTRICTIONSTORE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        name = "avx2";
+        return evaluateAvx2;
+    }
+    if (__builtin_cpu_supports("sse4.1"))
+    {
+        name = "sse4.1";
+        return evaluateSse41;
+    }
+#endif
+    name = "scalar";
+    return [](const RestrictionStore& rs, const int* freqs) { return evaluateScalar<CheckedAtEnd>(rs, freqs); };
+#endif
+}
+
+static const char* kernelName = "scalar";
+static const EvaluateKernel kernel = selectKernel(kernelName);
+
+
+/**
+ * @brief Calculates the total sum of the interferences of the violated restrictions
+ *
+ * @param [in]	restrictions	restrictions to evaluate
+ * @param [in]	freqs			frequency of every transistor
+ * @return sum of the interferences, accumulated in 64 bits
+ */
+
+long long evaluateRestrictions(const RestrictionStore& restrictions, const int* freqs)
+{
+    return kernel(restrictions, freqs);
+}
+
+
+/**
+ * @brief Gets the name of the kernel used by evaluateRestrictions
+ *
+ * @return "avx2", "sse4.1" or "scalar"
+ */
+
+const char* evaluateKernelName()
+{
+    return kernelName;
+}
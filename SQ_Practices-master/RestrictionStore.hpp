@@ -0,0 +1,36 @@
+/**
+ * @file RestrictionStore.hpp
+ * @brief header files for RestrictionStore struct declaration and the evaluation kernels
+ *
+ */
+
+#ifndef RESTRICTIONSTORE_HPP
+#define RESTRICTIONSTORE_HPP
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Restrictions stored as a structure of arrays
+ *
+ * Restriction k is made of trans1[k], trans2[k], bound[k] and interference[k]. Keeping
+ * each field contiguous lets the evaluation kernel load several restrictions at once.
+ */
+
+struct RestrictionStore
+{
+    std::vector<int32_t> trans1;		///< First transistor
+    std::vector<int32_t> trans2;		///< Second transistor
+    std::vector<int32_t> bound;			///< Bound of frequency difference when a interference starts to appear
+    std::vector<int32_t> interference;	///< Interference produced
+
+    unsigned size() const { return trans1.size(); }
+};
+
+
+long long evaluateRestrictions(const RestrictionStore& restrictions, const int* freqs);
+
+const char* evaluateKernelName();
+
+
+#endif /* RESTRICTIONSTORE_HPP */
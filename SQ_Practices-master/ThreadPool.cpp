@@ -0,0 +1,143 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief Sources for the class ThreadPool
+ *
+ */
+
+#include "ThreadPool.hpp"
+
+/**
+ * @brief Default constructor
+ *
+ * @param [in]	nHilos	number of threads, including the caller. 0 uses every hardware thread
+ */
+
+ThreadPool::ThreadPool(unsigned nHilos) :
+        tarea_(nullptr), total_(0), siguiente_(0), ocupados_(0), generacion_(0), parar_(false)
+{
+    if (nHilos == 0)
+        nHilos = std::thread::hardware_concurrency();
+    if (nHilos == 0)
+        nHilos = 1;
+
+    for (unsigned i = 1; i < nHilos; ++i)
+        hilos_.emplace_back(&ThreadPool::trabajar, this);
+}
+
+
+/**
+ * @brief Destroyer
+ *
+ * Stops and joins the worker threads
+ */
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        parar_ = true;
+    }
+    hayTrabajo_.notify_all();
+    for (unsigned i = 0; i < hilos_.size(); ++i)
+        hilos_[i].join();
+}
+
+
+/**
+ * @brief Gets the number of threads that run a loop, including the caller
+ *
+ * @return number of threads
+ */
+
+unsigned ThreadPool::getHilos() const
+{
+    return hilos_.size() + 1;
+}
+
+
+/**
+ * @brief Runs tarea(0) .. tarea(n-1) on the threads of the pool and waits for all of them
+ *
+ * The iterations must be independent of each other. If any of them throws, the first
+ * exception is thrown again here once the loop has finished.
+ *
+ * @param [in]	n		number of iterations
+ * @param [in]	tarea	body of the loop, receives the iteration number
+ */
+
+void ThreadPool::parallelFor(unsigned n, const std::function<void(unsigned)>& tarea)
+{
+    if (hilos_.empty() || n <= 1)
+    {
+        for (unsigned i = 0; i < n; ++i)
+            tarea(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tarea_ = &tarea;
+        total_ = n;
+        siguiente_ = 0;
+        ocupados_ = hilos_.size();
+        error_ = nullptr;
+        ++generacion_;
+    }
+    hayTrabajo_.notify_all();
+
+    ejecutar();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    terminado_.wait(lock, [this] { return ocupados_ == 0; });
+    tarea_ = nullptr;
+    if (error_)
+        std::rethrow_exception(error_);
+}
+
+
+/**
+ * @brief Takes iterations of the current loop until there are none left
+ *
+ */
+
+void ThreadPool::ejecutar()
+{
+    for (unsigned i = siguiente_++; i < total_; i = siguiente_++)
+    {
+        try
+        {
+            (*tarea_)(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_)
+                error_ = std::current_exception();
+        }
+    }
+}
+
+
+/**
+ * @brief Main loop of every worker thread
+ *
+ */
+
+void ThreadPool::trabajar()
+{
+    unsigned vista = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            hayTrabajo_.wait(lock, [&] { return parar_ || generacion_ != vista; });
+            if (parar_)
+                return;
+            vista = generacion_;
+        }
+
+        ejecutar();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--ocupados_ == 0)
+            terminado_.notify_one();
+    }
+}
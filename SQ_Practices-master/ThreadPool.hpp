@@ -0,0 +1,54 @@
+/**
+ * @file ThreadPool.hpp
+ * @brief Headers declarations for class ThreadPool
+ *
+ */
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+/**
+ * @brief Fixed set of worker threads that share the iterations of a loop
+ *
+ * The thread calling parallelFor works as one more worker, so a pool of N threads
+ * only starts N-1 of them. With a single thread every loop runs serially.
+ */
+
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned nHilos = 0);
+    virtual ~ThreadPool();
+
+    void parallelFor(unsigned n, const std::function<void(unsigned)>& tarea);
+    unsigned getHilos() const;
+
+private:
+    ThreadPool(const ThreadPool& orig);
+    ThreadPool& operator=(const ThreadPool& orig);
+
+    void trabajar();
+    void ejecutar();
+
+    std::vector<std::thread> hilos_;						///< Worker threads
+    std::mutex mutex_;										///< Protects the state of the current loop
+    std::condition_variable hayTrabajo_;					///< Signals the workers that a loop has started
+    std::condition_variable terminado_;						///< Signals the caller that the workers are done
+
+    const std::function<void(unsigned)>* tarea_;			///< Body of the current loop
+    unsigned total_;										///< Number of iterations of the current loop
+    std::atomic<unsigned> siguiente_;						///< Next iteration to be taken
+    unsigned ocupados_;										///< Workers still inside the current loop
+    unsigned generacion_;									///< Number of loops started, wakes the workers
+    bool parar_;											///< Tells the workers to finish
+    std::exception_ptr error_;								///< First exception thrown by the current loop
+};
+
+#endif /* THREADPOOL_HPP */
@@ -0,0 +1,173 @@
+/**
+ * @file Trace.cpp
+ * @brief Sources for the class Trace
+ *
+ */
+
+#include "Trace.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+/**
+ * @brief Default constructor, opens the file and starts the writer thread
+ *
+ * @param [in]	path		path of the file, JSON lines if it ends in .jsonl or .json and CSV otherwise
+ * @param [in]	capacidad	number of records the buffer holds, rounded up to a power of two
+ */
+
+Trace::Trace(const std::string& path, unsigned capacidad) : escritura_(0), lectura_(0), perdidos_(0),
+        parar_(false)
+{
+    uint64_t tam = 2;
+    while (tam < capacidad)
+        tam <<= 1;
+    celdas_.reset(new Celda[tam]);
+    for (uint64_t i = 0; i < tam; ++i)
+        celdas_[i].secuencia.store(i, std::memory_order_relaxed);
+    mascara_ = tam - 1;
+
+    file_ = std::fopen(path.c_str(), "w");
+    if (!file_)
+        throw std::runtime_error("Can not write the trace " + path);
+    json_ = (path.size() >= 6 && path.compare(path.size() - 6, 6, ".jsonl") == 0)
+            || (path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0);
+    if (!json_)
+        std::fputs("isla,generacion,segundos,evaluaciones,mejor,media,peor,diversidad\n", file_);
+
+    hilo_ = std::thread(&Trace::escritor, this);
+}
+
+
+/**
+ * @brief Destroyer
+ *
+ * Waits until every record in the buffer has been written and closes the file
+ */
+
+Trace::~Trace()
+{
+    parar_.store(true, std::memory_order_release);
+    hilo_.join();
+    std::fclose(file_);
+}
+
+
+/**
+ * @brief Adds a record to the buffer, it can be called from several threads at once
+ *
+ * @param [in]	registro	record to add
+ * @return false if the buffer was full and the record has been dropped
+ */
+
+bool Trace::registrar(const Registro& registro)
+{
+    uint64_t pos = escritura_.load(std::memory_order_relaxed);
+    Celda* celda;
+    for (;;)
+    {
+        celda = &celdas_[pos & mascara_];
+        int64_t turno = (int64_t)(celda->secuencia.load(std::memory_order_acquire) - pos);
+        if (turno == 0)
+        {
+            if (escritura_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (turno < 0)
+        {
+            // La celda aun no se ha leido desde la vuelta anterior: el buffer esta lleno
+            perdidos_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else
+            pos = escritura_.load(std::memory_order_relaxed);
+    }
+
+    celda->registro = registro;
+    celda->secuencia.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+
+/**
+ * @brief Gets the number of records dropped because the buffer was full
+ *
+ * @return records dropped
+ */
+
+uint64_t Trace::getPerdidos() const
+{
+    return perdidos_.load(std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief Takes the oldest record of the buffer, only called by the writer thread
+ *
+ * @param [out]	registro	record taken
+ * @return false if there is no record ready
+ */
+
+bool Trace::sacar(Registro& registro)
+{
+    Celda& celda = celdas_[lectura_ & mascara_];
+    if (celda.secuencia.load(std::memory_order_acquire) != lectura_ + 1)
+        return false;
+
+    registro = celda.registro;
+    celda.secuencia.store(lectura_ + mascara_ + 1, std::memory_order_release);
+    ++lectura_;
+    return true;
+}
+
+
+/**
+ * @brief Writes a record to the file
+ *
+ * @param [in]	registro	record to write
+ */
+
+void Trace::escribir(const Registro& r)
+{
+    if (json_)
+        std::fprintf(file_, "{\"isla\":%u,\"generacion\":%llu,\"segundos\":%.6f,\"evaluaciones\":%.3f,"
+                "\"mejor\":%d,\"media\":%.3f,\"peor\":%d,\"diversidad\":%.4f}\n",
+                r.isla, (unsigned long long)r.generacion, r.segundos, r.evaluaciones,
+                r.mejor, r.media, r.peor, r.diversidad);
+    else
+        std::fprintf(file_, "%u,%llu,%.6f,%.3f,%d,%.3f,%d,%.4f\n",
+                r.isla, (unsigned long long)r.generacion, r.segundos, r.evaluaciones,
+                r.mejor, r.media, r.peor, r.diversidad);
+}
+
+
+/**
+ * @brief Body of the writer thread
+ *
+ * Empties the buffer every few milliseconds, so it does not compete for the processor
+ * with the search, and when it is told to stop writes what is left.
+ */
+
+void Trace::escritor()
+{
+    Registro registro;
+    for (;;)
+    {
+        bool parar = parar_.load(std::memory_order_acquire);
+        bool escrito = false;
+        while (sacar(registro))
+        {
+            escribir(registro);
+            escrito = true;
+        }
+        if (escrito)
+            std::fflush(file_);
+        if (parar)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    uint64_t perdidos = getPerdidos();
+    if (perdidos && !json_)
+        std::fprintf(file_, "# %llu records dropped\n", (unsigned long long)perdidos);
+    else if (perdidos)
+        std::fprintf(file_, "{\"perdidos\":%llu}\n", (unsigned long long)perdidos);
+}
@@ -0,0 +1,82 @@
+/**
+ * @file Trace.hpp
+ * @brief Headers declarations for class Trace
+ *
+ */
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+/**
+ * @brief Convergence trace of a search, written to a file by a background thread
+ *
+ * The populations add a record per generation to a ring buffer allocated once, with no
+ * lock and no allocation, so the hot loop only pays for computing the record. The ring
+ * buffer accepts several producers, like the islands of the island model, and a single
+ * consumer: a thread that writes the records as CSV or, if the file name ends in .jsonl
+ * or .json, as JSON lines. When the buffer is full the record is dropped and counted
+ * instead of making the search wait.
+ */
+
+class Trace {
+public:
+    /**
+     * @brief State of a population after a generation
+     */
+    struct Registro
+    {
+        unsigned isla;					///< Island of the population, 0 without islands
+        uint64_t generacion;			///< Generations made by the population
+        double segundos;				///< Seconds since the search started
+        double evaluaciones;			///< Evaluations charged to the budget of the population
+        int mejor;						///< Best interference of the population
+        double media;					///< Mean interference
+        int peor;						///< Worst interference
+        double diversidad;				///< Fraction of individuals with no copy in the population
+    };
+
+    explicit Trace(const std::string& path, unsigned capacidad = 1 << 16);
+    Trace(const Trace& orig) = delete;
+    Trace& operator=(const Trace& orig) = delete;
+    virtual ~Trace();
+
+    bool registrar(const Registro& registro);
+    uint64_t getPerdidos() const;
+
+private:
+    /**
+     * @brief Slot of the ring buffer
+     *
+     * The sequence number tells whose turn it is: it is equal to the position of the
+     * producer that may fill it and to that position plus one once it has been filled.
+     */
+    struct Celda
+    {
+        std::atomic<uint64_t> secuencia;	///< Turn of the slot
+        Registro registro;					///< Record stored in the slot
+    };
+
+    bool sacar(Registro& registro);
+    void escribir(const Registro& registro);
+    void escritor();
+
+    std::unique_ptr<Celda[]> celdas_;			///< Slots of the ring buffer, a power of two of them
+    uint64_t mascara_;							///< Number of slots minus one
+    alignas(64) std::atomic<uint64_t> escritura_;	///< Next position to be filled by a producer
+    alignas(64) uint64_t lectura_;				///< Next position to be read by the writer thread
+    std::atomic<uint64_t> perdidos_;			///< Records dropped because the buffer was full
+
+    FILE* file_;								///< File being written
+    bool json_;									///< Whether records are written as JSON lines
+    std::atomic<bool> parar_;					///< Tells the writer thread to empty the buffer and end
+    std::thread hilo_;							///< Writer thread
+};
+
+#endif /* TRACE_HPP */
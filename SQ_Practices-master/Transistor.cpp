@@ -37,11 +37,12 @@ int Transistor::getNRange()
 /**
  * @brief Gets a random frequency inside his set of frequencies
  *
+ * @param [in,out]	rng		random number generator
  * @return Random frequencies within his range of frequencies inside the frequencies matrix.
  */
-int Transistor::getRandFrec()
+int Transistor::getRandFrec(RandomGenerator& rng)
 {   
-    int frecuencia=getRandomInt(0,getFreqRange()-1);
+    int frecuencia=rng.getInt(0,getFreqRange()-1);
     return frecuencia;
 }
 
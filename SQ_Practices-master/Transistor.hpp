@@ -24,7 +24,7 @@ class Transistor{
     public: 
     Transistor(unsigned numID, int NRange, std::vector<std::vector<int>>* frecs);
     int getNRange(); 
-    int getRandFrec();
+    int getRandFrec(RandomGenerator& rng);
     int getFreqRange();
     int getNumID();
 
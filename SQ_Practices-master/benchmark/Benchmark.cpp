@@ -0,0 +1,435 @@
+/**
+ * @file Benchmark.cpp
+ * @brief Micro-benchmarks of the hot kernels of the solver
+ *
+ * Every kernel is run in batches that grow until a batch takes a minimum time, and the
+ * time and memory allocations per operation of the last batch are reported. The
+ * instances are fixed: synthetic ones generated from a fixed seed, plus any instance
+ * folder given in the command line, so two versions of the program can be compared
+ * running the same benchmark.
+ *
+ * Usage: SQ_Benchmark [-json FILE] [-time SECONDS] [-synthetic N]... [-uc] [INSTANCE]...
+ */
+
+#include "../Parser.hpp"
+#include "../Especimen.hpp"
+#include "../ConflictSet.hpp"
+#include "../CostTable.hpp"
+#include "../Poblacion.hpp"
+#include "../Random.hpp"
+#include "../InstanceGenerator.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static std::atomic<unsigned long long> reservas(0);			///< Memory allocations made since the program started
+static std::atomic<unsigned long long> bytesReservados(0);	///< Bytes allocated since the program started
+
+void* operator new(size_t n)
+{
+    ++reservas;
+    bytesReservados += n;
+    void* p = std::malloc(n ? n : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+
+/**
+ * @brief Value written by every operation, so the compiler can not remove them
+ */
+static volatile long long sumidero = 0;
+
+
+/**
+ * @brief Measure of a kernel over an instance
+ */
+struct Resultado
+{
+    std::string instancia;				///< Name of the instance
+    std::string nombre;					///< Name of the kernel
+    unsigned long long iteraciones;		///< Operations of the measured batch
+    double nsPorOp;						///< Nanoseconds per operation
+    double evaluacionesPorOp;			///< Evaluations made by each operation, 0 if it does not evaluate
+    double bytesPorOp;					///< Bytes of input read by each operation, 0 if it does not read files
+    double reservasPorOp;				///< Memory allocations per operation
+    double bytesReservadosPorOp;		///< Bytes allocated per operation
+};
+
+
+/**
+ * @brief Instance loaded in the structures used by the solver
+ */
+struct Instancia
+{
+    std::string nombre;					///< Name shown in the results
+    std::string dom, var, ctr;			///< Paths of the text files
+    DomainTable domains;				///< Frequencies available to each transistor
+    RestrictionStore restrictions;		///< Restrictions as a structure of arrays
+    Adjacency adjacency;				///< Restrictions incident to each transistor
+};
+
+
+/**
+ * @brief Runs an operation in batches until a batch lasts at least a given time
+ *
+ * @param [in]	instancia			name of the instance
+ * @param [in]	nombre				name of the kernel
+ * @param [in]	op					operation to measure
+ * @param [in]	evaluacionesPorOp	evaluations made by each operation
+ * @param [in]	bytesPorOp			bytes of input read by each operation
+ * @param [in]	tiempo				minimum duration of the measured batch, in seconds
+ * @return the measure of the last batch
+ */
+
+template <typename Op>
+static Resultado medir(const std::string& instancia, const std::string& nombre, Op op,
+        double evaluacionesPorOp, double bytesPorOp, double tiempo)
+{
+    op();
+    unsigned long long n = 1;
+    while (true)
+    {
+        unsigned long long r0 = reservas, b0 = bytesReservados;
+        auto inicio = std::chrono::steady_clock::now();
+        for (unsigned long long i = 0; i < n; ++i)
+            op();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - inicio).count();
+        unsigned long long r = reservas - r0, b = bytesReservados - b0;
+
+        if (ns >= tiempo * 1e9 || n >= (1ull << 40))
+            return Resultado{instancia, nombre, n, ns / n, evaluacionesPorOp, bytesPorOp,
+                    (double)r / n, (double)b / n};
+
+        // Siguiente tanda con el tamano estimado para llegar al tiempo, sin crecer mas de 10 veces
+        double objetivo = ns > 0 ? tiempo * 1e9 / ns * n * 1.2 : n * 10.0;
+        n = std::max(n + 1, std::min(n * 10, (unsigned long long)objetivo));
+    }
+}
+
+
+/**
+ * @brief Gets the size of a file
+ *
+ * @param [in]	path	path of the file
+ * @return size in bytes, 0 if it does not exist
+ */
+
+static double tamFichero(const std::string& path)
+{
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? info.st_size : 0;
+}
+
+
+/**
+ * @brief Parses an instance the same way the solver does
+ *
+ * @param [in,out]	ins		instance with the paths of its files, its structures are filled
+ */
+
+static void cargar(Instancia& ins)
+{
+    std::vector<Restriction> restrictions;
+    std::vector<std::vector<int>> freqs;
+    std::vector<Transistor> transistors;
+    std::vector<int> equivalenceIndex;
+
+    Parser::FRangeParse(ins.dom, freqs);
+    Parser::TParse(ins.var, &freqs, transistors, equivalenceIndex, INT_MAX);
+    Parser::RTParse(ins.ctr, restrictions, equivalenceIndex, 1);
+    Parser::genAdjacency(transistors, restrictions, ins.adjacency);
+    Parser::genRestrictionStore(restrictions, ins.restrictions);
+    Parser::genDomainTable(freqs, transistors, ins.domains);
+}
+
+
+/**
+ * @brief Runs every benchmark over an instance
+ *
+ * @param [in,out]	ins			instance
+ * @param [in]		tiempo		minimum duration of each measure, in seconds
+ * @param [in,out]	resultados	vector in which the measures are added
+ */
+
+static void medirInstancia(Instancia& ins, double tiempo, std::vector<Resultado>& resultados)
+{
+    const std::string& n = ins.nombre;
+
+    // Parser
+    std::vector<std::vector<int>> freqs;
+    std::vector<Transistor> transistors;
+    std::vector<int> equivalenceIndex;
+    resultados.push_back(medir(n, "Parser::FRangeParse", [&]() {
+        std::vector<std::vector<int>> f;
+        Parser::FRangeParse(ins.dom, f);
+        sumidero = f.size();
+    }, 0, tamFichero(ins.dom), tiempo));
+    Parser::FRangeParse(ins.dom, freqs);
+
+    resultados.push_back(medir(n, "Parser::TParse", [&]() {
+        std::vector<Transistor> t;
+        std::vector<int> e;
+        sumidero = Parser::TParse(ins.var, &freqs, t, e, INT_MAX);
+    }, 0, tamFichero(ins.var), tiempo));
+    Parser::TParse(ins.var, &freqs, transistors, equivalenceIndex, INT_MAX);
+
+    resultados.push_back(medir(n, "Parser::RTParse", [&]() {
+        std::vector<Restriction> r;
+        Parser::RTParse(ins.ctr, r, equivalenceIndex, 1);
+        sumidero = r.size();
+    }, 0, tamFichero(ins.ctr), tiempo));
+
+    // Individuos
+    RandomGenerator rng(12345);
+    Especimen a(&ins.domains, &ins.restrictions, &ins.adjacency, rng);
+    Especimen b(&ins.domains, &ins.restrictions, &ins.adjacency, rng);
+    unsigned nTrans = ins.domains.numTransistors();
+
+    resultados.push_back(medir(n, "Especimen::evaluate", [&]() {
+        sumidero = a.evaluate();
+    }, 1, 0, tiempo));
+
+    unsigned t = 0;
+    std::vector<int> deltas;
+    resultados.push_back(medir(n, "Especimen::scanVal", [&]() {
+        t = t + 1 < nTrans ? t + 1 : 0;
+        sumidero = a.scanVal(t, ins.domains.size(t) > 1 ? 1 : 0);
+    }, 0, 0, tiempo));
+
+    resultados.push_back(medir(n, "Especimen::deltasMovimiento", [&]() {
+        t = t + 1 < nTrans ? t + 1 : 0;
+        a.deltasMovimiento(t, deltas);
+        sumidero = deltas[0];
+    }, 0, 0, tiempo));
+
+    // Un transistor al azar pasa a otra frecuencia al azar, asi ningun movimiento se queda donde estaba
+    CostTable tabla(&ins.domains, &ins.adjacency, &a);
+    resultados.push_back(medir(n, "CostTable::mover", [&]() {
+        unsigned trans = rng.getInt(0, nTrans - 1);
+        int rango = ins.domains.size(trans);
+        int destino = rango > 1 ? (a.getIndice(trans) + rng.getInt(1, rango - 1)) % rango : 0;
+        tabla.mover(trans, destino);
+        sumidero = a.getInterference();
+    }, 0, 0, tiempo));
+
+    resultados.push_back(medir(n, "CostTable::mejorMovimiento", [&]() {
+        unsigned trans;
+        int destino;
+        sumidero = tabla.mejorMovimiento(trans, destino);
+    }, 0, 0, tiempo));
+
+    // Un movimiento de la busqueda tabu: los deltas de un transistor en conflicto y su mejor frecuencia
+    ConflictSet conflictos(&ins.domains, &ins.adjacency, &b);
+    resultados.push_back(medir(n, "ConflictSet::deltas+mover", [&]() {
+        if (conflictos.numConflictivos() == 0)
+            return;
+        unsigned trans = conflictos.conflictivo(rng.getInt(0, conflictos.numConflictivos() - 1));
+        conflictos.deltas(trans, deltas);
+        int destino = (b.getIndice(trans) + 1) % deltas.size();
+        for (unsigned i = 0; i < deltas.size(); ++i)
+            if ((int)i != b.getIndice(trans) && deltas[i] < deltas[destino])
+                destino = i;
+        conflictos.mover(trans, destino);
+        sumidero = b.getInterference();
+    }, 0, 0, tiempo));
+
+    resultados.push_back(medir(n, "cruceBlx", [&]() {
+        cruceBlx(a, b, rng);
+    }, 0, 0, tiempo));
+
+    resultados.push_back(medir(n, "cruce2Puntos", [&]() {
+        cruce2Puntos(a, b, rng);
+    }, 0, 0, tiempo));
+
+    resultados.push_back(medir(n, "mutar", [&]() {
+        mutar(a, rng);
+    }, 0, 0, tiempo));
+
+    a.evaluate();
+    resultados.push_back(medir(n, "mutar+Especimen::evaluateDelta", [&]() {
+        mutar(a, rng);
+        sumidero = a.evaluateDelta();
+    }, 1, 0, tiempo));
+
+    // Poblacion
+    Poblacion poblacion(&ins.domains, &ins.restrictions, &ins.adjacency, 12345, 1);
+    poblacion.iniciarPoblacion(50);
+    resultados.push_back(medir(n, "Poblacion::evolucionGeneracional", [&]() {
+        poblacion.evolucionGeneracional(0.7, 0, 0.1);
+    }, 0, 0, tiempo));
+
+    resultados.push_back(medir(n, "Poblacion::comprobarRepetidos", [&]() {
+        sumidero = poblacion.comprobarRepetidos();
+    }, 0, 0, tiempo));
+}
+
+
+/**
+ * @brief Escapes a string to be written inside a JSON string
+ *
+ * @param [in]	texto	string to escape
+ * @return the escaped string
+ */
+
+static std::string escaparJson(const std::string& texto)
+{
+    std::string result;
+    for (char c : texto)
+    {
+        if (c == '"' || c == '\\')
+            result += '\\';
+        if ((unsigned char)c < 0x20)
+            result += ' ';
+        else
+            result += c;
+    }
+    return result;
+}
+
+
+/**
+ * @brief Writes the measures as a JSON document
+ *
+ * @param [in]	out			file in which the document is written
+ * @param [in]	resultados	measures
+ */
+
+static void escribirJson(FILE* out, const std::vector<Resultado>& resultados)
+{
+    std::fprintf(out, "{\n  \"version\": 1,\n  \"results\": [\n");
+    for (unsigned i = 0; i < resultados.size(); ++i)
+    {
+        const Resultado& r = resultados[i];
+        double opsPorSeg = r.nsPorOp > 0 ? 1e9 / r.nsPorOp : 0;
+        std::fprintf(out, "    {\"instance\": \"%s\", \"name\": \"%s\", \"iterations\": %llu, "
+                "\"ns_per_op\": %.3f, \"ops_per_s\": %.3f, \"evaluations_per_s\": %.3f, "
+                "\"mb_per_s\": %.3f, \"allocs_per_op\": %.3f, \"alloc_bytes_per_op\": %.3f}%s\n",
+                escaparJson(r.instancia).c_str(), escaparJson(r.nombre).c_str(), r.iteraciones,
+                r.nsPorOp, opsPorSeg, opsPorSeg * r.evaluacionesPorOp, opsPorSeg * r.bytesPorOp / 1e6,
+                r.reservasPorOp, r.bytesReservadosPorOp, i + 1 < resultados.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+}
+
+
+/**
+ * @brief Main function of the benchmark
+ *
+ * @param [in]	argc	arguments of the benchmark
+ * @param [in]	argv	arguments of the benchmark
+ * @return 0, or 1 if the arguments are not correct
+ */
+
+int main(int argc, char** argv)
+{
+    std::string json;
+    double tiempo = 0.2;
+    bool mayusculas = false;
+    std::vector<unsigned> sinteticas;
+    std::vector<std::string> carpetas;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string opcion = argv[i];
+        if (opcion == "-json" && i + 1 < argc)
+            json = argv[++i];
+        else if (opcion == "-time" && i + 1 < argc)
+            tiempo = std::stod(argv[++i]);
+        else if (opcion == "-synthetic" && i + 1 < argc)
+            sinteticas.push_back(std::stoi(argv[++i]));
+        else if (opcion == "-uc")
+            mayusculas = true;
+        else if (!opcion.empty() && opcion[0] == '-')
+        {
+            std::fprintf(stderr, "Usage: %s [-json FILE] [-time SECONDS] [-synthetic N]... [-uc] [INSTANCE]...\n",
+                    argv[0]);
+            return 1;
+        }
+        else
+            carpetas.push_back(opcion);
+    }
+    if (sinteticas.empty() && carpetas.empty())
+        sinteticas = {300, 3000};
+
+    std::vector<Resultado> resultados;
+    try {
+        for (unsigned i = 0; i < sinteticas.size(); ++i)
+        {
+            char plantilla[] = "/tmp/sq_benchmarkXXXXXX";
+            if (!mkdtemp(plantilla))
+                throw std::runtime_error("Can not create a temporary folder");
+            std::string dir = plantilla;
+            GeneratorOptions options;
+            options.transistors = sinteticas[i];
+            options.degree = 20;
+            options.seed = 2017 + sinteticas[i];
+            InstanceGenerator(options).write(dir);
+
+            Instancia ins;
+            ins.nombre = "synthetic-" + std::to_string(sinteticas[i]);
+            ins.dom = dir + "/dom.txt"; ins.var = dir + "/var.txt"; ins.ctr = dir + "/ctr.txt";
+            cargar(ins);
+            medirInstancia(ins, tiempo, resultados);
+
+            std::remove(ins.dom.c_str()); std::remove(ins.var.c_str()); std::remove(ins.ctr.c_str());
+            rmdir(dir.c_str());
+        }
+
+        for (unsigned i = 0; i < carpetas.size(); ++i)
+        {
+            Instancia ins;
+            ins.nombre = carpetas[i];
+            ins.dom = carpetas[i] + (mayusculas ? "/DOM.TXT" : "/dom.txt");
+            ins.var = carpetas[i] + (mayusculas ? "/VAR.TXT" : "/var.txt");
+            ins.ctr = carpetas[i] + (mayusculas ? "/CTR.TXT" : "/ctr.txt");
+            cargar(ins);
+            medirInstancia(ins, tiempo, resultados);
+        }
+    } catch (std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    // Si el JSON va a la salida estandar la tabla va a la de error
+    FILE* tabla = json == "-" ? stderr : stdout;
+    std::fprintf(tabla, "%-16s %-36s %14s %14s %10s\n", "instance", "kernel", "ns/op", "ops/s", "allocs/op");
+    for (unsigned i = 0; i < resultados.size(); ++i)
+    {
+        const Resultado& r = resultados[i];
+        std::fprintf(tabla, "%-16s %-36s %14.1f %14.1f %10.2f\n", r.instancia.c_str(), r.nombre.c_str(),
+                r.nsPorOp, 1e9 / r.nsPorOp, r.reservasPorOp);
+    }
+
+    if (!json.empty())
+    {
+        FILE* out = json == "-" ? stdout : std::fopen(json.c_str(), "w");
+        if (!out)
+        {
+            std::fprintf(stderr, "Can not write %s\n", json.c_str());
+            return 1;
+        }
+        escribirJson(out, resultados);
+        if (out != stdout)
+            std::fclose(out);
+    }
+    return 0;
+}
@@ -4,15 +4,37 @@
 *
 */
 #include <cstdlib>
+#include <csignal>
+#include <functional>
+#include <memory>
 
 #include "Parser.hpp"
+#include "InstanceCache.hpp"
+#include "InstanceReorder.hpp"
 #include "Restriction.hpp"
 #include "Random.hpp"
 #include "Especimen.hpp"
 #include "Poblacion.hpp"
 #include "AlgoritmosGeneticos.hpp"
+#include "RecocidoSimulado.hpp"
+#include "ProgressReporter.hpp"
+#include "Trace.hpp"
+#include "Checkpoint.hpp"
 using namespace std;
 
+/**
+ * @brief Handler of SIGINT and SIGTERM, stops the search so the best assignment found is still written
+ *
+ * A second signal uses the default handler and ends the program at once.
+ * @param [in]	senal	signal received
+ */
+extern "C" void alInterrumpir(int senal)
+{
+    Budget::interrumpir();
+    std::signal(senal, SIG_DFL);
+}
+
+
 /**
  * @brief Main function of the program, in which attending to the given arguments, makes the necessary calls
  * to the functions and shows in screen the results obtained.
@@ -24,12 +46,125 @@ using namespace std;
 int main(int argc, char** argv) {
 
     try{
-        if (argc != 7)
+        if (argc < 7)
             throw std::domain_error("Number of arguments is not correct");
 
         std::string path = argv[1];     std::string argv2 = argv[2]; 
         std::string argv4 = argv[4];    std::string argv5 = argv[5];
         std::string argv6 = argv[6];
+
+        // Argumentos opcionales
+        unsigned hilos = 0;
+        int islas = 1, intervalo = 10, topologia = 0;
+        int replicas = 4;
+        bool usarCache = true;
+        bool componentes = false;
+        int reordenar = -1;
+        int limite = 1200;
+        double segundos = 0;
+        int evaluaciones = 20000;
+        bool mostrarProgreso = false;
+        std::string solucion_p, traza_p, checkpoint_p, reanudar_p;
+        double cadaCheckpoint = 60;
+        int busqueda = 0;
+        for (int i = 7; i < argc; ++i)
+        {
+            std::string opcion = argv[i];
+            if (opcion == "-threads" && i+1 < argc)
+                hilos = std::stoi(argv[++i]);
+            else if (opcion == "-islands" && i+1 < argc)
+                islas = std::stoi(argv[++i]);
+            else if (opcion == "-replicas" && i+1 < argc)
+                replicas = std::stoi(argv[++i]);
+            else if (opcion == "-migration" && i+1 < argc)
+                intervalo = std::stoi(argv[++i]);
+            else if (opcion == "-limit" && i+1 < argc)
+            {
+                limite = std::stoi(argv[++i]);
+                if (limite <= 0)
+                    limite = INT_MAX;
+            }
+            else if (opcion == "-time" && i+1 < argc)
+                segundos = std::stod(argv[++i]);
+            else if (opcion == "-evaluations" && i+1 < argc)
+            {
+                evaluaciones = std::stoi(argv[++i]);
+                if (evaluaciones <= 0)
+                    evaluaciones = INT_MAX;
+            }
+            else if (opcion == "-progress")
+                mostrarProgreso = true;
+            else if (opcion == "-solution" && i+1 < argc)
+                solucion_p = argv[++i];
+            else if (opcion == "-trace" && i+1 < argc)
+                traza_p = argv[++i];
+            else if (opcion == "-checkpoint" && i+1 < argc)
+                checkpoint_p = argv[++i];
+            else if (opcion == "-checkpoint-every" && i+1 < argc)
+                cadaCheckpoint = std::stod(argv[++i]);
+            else if (opcion == "-resume" && i+1 < argc)
+                reanudar_p = argv[++i];
+            else if (opcion == "-localsearch" && i+1 < argc)
+            {
+                std::string argBusqueda = argv[++i];
+                if (argBusqueda == "lineal")
+                    busqueda = 0;
+                else if (argBusqueda == "tabu")
+                    busqueda = 1;
+                else
+                    throw std::invalid_argument("El argumento no es correcto, las busquedas locales posibles "
+                            "son lineal y tabu");
+            }
+            else if (opcion == "-reorder" && i+1 < argc)
+            {
+                std::string argOrden = argv[++i];
+                if (argOrden == "bfs")
+                    reordenar = 0;
+                else if (argOrden == "rcm")
+                    reordenar = 1;
+                else
+                    throw std::invalid_argument("El argumento no es correcto, los ordenes posibles "
+                            "son bfs y rcm");
+            }
+            else if (opcion == "-components")
+                componentes = true;
+            else if (opcion == "-nocache")
+                usarCache = false;
+            else if (opcion == "-topology" && i+1 < argc)
+            {
+                std::string argTopologia = argv[++i];
+                if (argTopologia == "ring")
+                    topologia = 0;
+                else if (argTopologia == "random")
+                    topologia = 1;
+                else
+                    throw std::invalid_argument("El argumento no es correcto, las topologias posibles "
+                            "son ring y random");
+            }
+            else
+                throw std::invalid_argument("El argumento " + opcion + " no es correcto, los argumentos "
+                        "opcionales posibles son -threads N para evaluar con N hilos, -islands N para "
+                        "usar N islas, -migration K para migrar cada K generaciones y -topology "
+                        "ring|random para elegir la topologia de migracion, -replicas N para usar N temperaturas en el "
+                        "recocido, -limit N para leer los transistores "
+                        "hasta el id N (0 sin limite), -time S para parar a los S segundos, -evaluations N para "
+                        "parar tras N evaluaciones (0 sin limite), -progress para mostrar cada mejora, "
+                        "-solution FICHERO para guardar la mejor asignacion, -trace FICHERO para guardar la "
+                        "convergencia, -checkpoint FICHERO para guardar la busqueda cada -checkpoint-every S "
+                        "segundos, -resume FICHERO para continuarla, -localsearch lineal|tabu para elegir la "
+                        "busqueda local de los memeticos, -components para resolver cada componente conexa por "
+                        "separado, -reorder bfs|rcm para renumerar los transistores por vecindad y -nocache para leer "
+                        "siempre los ficheros de texto");
+        }
+        if (islas > 1 && argv4 != "generacional" && argv4 != "estacionario")
+            throw std::invalid_argument("El modelo de islas solo se puede usar con los modelos "
+                    "generacional y estacionario");
+        if (islas > 1 && (!checkpoint_p.empty() || !reanudar_p.empty()))
+            throw std::invalid_argument("El modelo de islas no se puede guardar ni continuar");
+        if (componentes && (!checkpoint_p.empty() || !reanudar_p.empty() || !traza_p.empty()))
+            throw std::invalid_argument("La busqueda por componentes no se puede guardar, continuar ni trazar");
+        if (argv4 == "recocido" && (!checkpoint_p.empty() || !reanudar_p.empty()))
+            throw std::invalid_argument("El recocido no se puede guardar ni continuar");
         
         std::string dom_p, var_p, ctr_p;
         if(argv2 == "-uc")
@@ -61,54 +196,125 @@ int main(int argc, char** argv) {
         std::string seedString = argv[3];
         int seed = std::stoi(seedString);
 
-        std::srand(seed);
-        std::vector<Restriction> restrictions;
-        std::vector<std::vector<int>> freqs;
-        std::vector<Transistor> transistors;
+        Adjacency adjacency;
+        RestrictionStore restrictionStore;
+        DomainTable domains;
+        
+        // Si la instancia ya se leyo antes se toma de su copia binaria
+        std::string cache_p = path + "/instance.cache";
+        std::vector<std::string> fuentes = {path + dom_p, path + var_p, path + ctr_p};
+        if (!usarCache || !InstanceCache::load(cache_p, fuentes, limite, domains, restrictionStore,
+                adjacency))
+        {
+            std::vector<Restriction> restrictions;
+            std::vector<std::vector<int>> freqs;
+            std::vector<Transistor> transistors;
 
-        Parser::FRangeParse(path + dom_p, freqs);
-        std::vector<int> equivalenceIndex;
-        Parser::TParse(path + var_p, &freqs, transistors, equivalenceIndex, 1200);
-        Parser::RTParse(path + ctr_p, restrictions, equivalenceIndex);
-        std::vector<unsigned> indxTransRest;
-        Parser::genIndexTransRestr(transistors, restrictions, indxTransRest);
-        Poblacion poblacionActual(&transistors, &restrictions, &indxTransRest);
-        poblacionActual.iniciarPoblacion(20);
+            Parser::FRangeParse(path + dom_p, freqs);
+            std::vector<int> equivalenceIndex;
+            Parser::TParse(path + var_p, &freqs, transistors, equivalenceIndex, limite);
+            Parser::RTParse(path + ctr_p, restrictions, equivalenceIndex, hilos);
+            Parser::genAdjacency(transistors, restrictions, adjacency);
+            Parser::genRestrictionStore(restrictions, restrictionStore);
+            Parser::genDomainTable(freqs, transistors, domains);
+            
+            if (usarCache)
+                InstanceCache::save(cache_p, fuentes, limite, domains, restrictionStore,
+                        adjacency);
+        }
+        // La cache guarda el orden de los ficheros, la renumeracion se hace en cada ejecucion
+        if (reordenar >= 0)
+            InstanceReorder::reorder(reordenar, domains, restrictionStore, adjacency);
+        // Cada mejora se muestra en la salida de error, para no mezclarla con el resultado
+        ProgressReporter progreso(mostrarProgreso ? &std::cerr : nullptr);
+        std::signal(SIGINT, alInterrumpir);
+        std::signal(SIGTERM, alInterrumpir);
+        std::unique_ptr<Trace> traza;
+        if (!traza_p.empty())
+            traza.reset(new Trace(traza_p));
+
+        Checkpoint checkpoint(checkpoint_p, cadaCheckpoint, argv4 + " " + argv5 + (busqueda ? " tabu" : "")
+                + (reordenar == 0 ? " bfs" : reordenar == 1 ? " rcm" : ""));
+
+        Poblacion poblacionActual(&domains, &restrictionStore, &adjacency, seed, hilos);
+        poblacionActual.getBudget().setLimiteTiempo(segundos);
+        poblacionActual.setProgreso(&progreso);
+        poblacionActual.setTraza(traza.get());
+        poblacionActual.setCheckpoint(&checkpoint);
+        
+        // Al continuar una busqueda la poblacion es la del checkpoint, no una nueva
+        if (!reanudar_p.empty())
+        {
+            checkpoint.cargar(reanudar_p);
+            checkpoint.restaurar(poblacionActual);
+        } else
+        {
+            poblacionActual.iniciarPoblacion(20);
+            checkpoint.setInicial(poblacionActual.getMejorInterferencia());
+        }
 
         if (argv6 == "-t")
-            std::cout << "Interferencia Inicial\tInterferencia Final " << std::endl;
+            std::cout << "Interferencia Inicial\tInterferencia Final\tEvaluaciones\tSegundos " << std::endl;
         else if (argv6 != "-o")
             throw std::invalid_argument("El argumento no es correcto, los argumentos posibles son -t "
                     "para mostrar en terminal y -o para mostrar solucion optimizada para guardar en "
                     "un fichero de texto"
                    );
 
-        std::cout << poblacionActual.getMejor().getInterference() << "\t";
+        std::cout << checkpoint.getInicial() << "\t";
         if (argv6 == "-t")
             std::cout << "\t\t";
         if (argv4 != "greedy")
         {
+            // El modelo elegido, sobre la instancia completa o sobre cada una de sus componentes
+            std::function<int(Poblacion&)> resolver = [&](Poblacion& poblacion) {
+                if(argv4 == "generacional" && islas > 1)
+                    return islasGeneracional(islas, intervalo, topologia, 50, evaluaciones, poblacion, 0.7, tipoCruce, 0.1);
+                else if (argv4 == "estacionario" && islas > 1)
+                    return islasEstacionario(islas, intervalo, topologia, 50, evaluaciones, poblacion, 1, 1, 0.1);
+                else if(argv4 == "generacional")
+                    return geneticoGeneracional(50, evaluaciones, poblacion, 0.7, tipoCruce, 0.1);
+                else if (argv4 == "estacionario")
+                    return geneticoEstacionario(50,evaluaciones,poblacion,1,1,0.1);
+                else if (argv4 == "am1010")
+                    return am1010(20,evaluaciones,poblacion,0.7,tipoCruce,0.1,busqueda);
+                else if (argv4 == "am1001")
+                    return am1001(20,evaluaciones,poblacion,0.7,tipoCruce,0.1,busqueda);
+                else if (argv4 == "am1001Mej")
+                    return am1001Mej(20,evaluaciones,poblacion,0.7,tipoCruce,0.1,busqueda);
+                else if (argv4 == "tabu")
+                    return algoritmoTabu(evaluaciones,poblacion);
+                else if (argv4 == "recocido")
+                    return recocidoParalelo(replicas,evaluaciones,poblacion);
+                else
+                    throw std::invalid_argument("El argumento no es correcto, los argumentos posibles son "
+                        "generacional para seguir un modelo de evolución generacional o estacionario para "
+                        "seguir un modelo de evolución estacionario, am1010, am1001 y am1001Mej para los memeticos, "
+                        "tabu para una busqueda tabu desde el mejor individuo, recocido para un recocido simulado con "
+                        "varias temperaturas. Greedy para indicar solo solución greedy inicial"
+                       );
+            };
+
             int mejor;
-            if(argv4 == "generacional")
-                mejor = geneticoGeneracional(50, 20000, poblacionActual, 0.7, tipoCruce, 0.1);
-            else if (argv4 == "estacionario")
-                mejor = geneticoEstacionario(50,20000,poblacionActual,1,1,0.1);
-            else if (argv4 == "am1010")
-                mejor = am1010(20,20000,poblacionActual,0.7,tipoCruce,0.1);
-            else if (argv4 == "am1001")
-                mejor = am1001(20,20000,poblacionActual,0.7,tipoCruce,0.1);
-            else if (argv4 == "am1001Mej")
-                mejor = am1001Mej(20,20000,poblacionActual,0.7,tipoCruce,0.1);
-            else
-                throw std::invalid_argument("El argumento no es correcto, los argumentos posibles son "
-                    "generacional para seguir un modelo de evolución generacional o estacionario para "
-                    "seguir un modelo de evolución estacionario. Greedy para indicar solo solución greedy inicial"
-                   );
+            if (componentes)
+            {
+                std::vector<SubInstance> subinstancias;
+                std::vector<unsigned> aislados;
+                InstanceSplitter::split(domains, restrictionStore, adjacency, subinstancias, aislados);
+                mejor = modeloComponentes(subinstancias, hilos, poblacionActual, resolver);
+            } else
+                mejor = resolver(poblacionActual);
 
             std::cout << mejor << "\t";
         }
+        if (!solucion_p.empty() && !progreso.escribirSolucion(solucion_p, domains))
+            throw std::runtime_error("No se ha podido guardar la solucion en " + solucion_p);
         if (argv6 == "-t")
-            std::cout << std::endl;
+        {
+            const Budget& presupuesto = poblacionActual.getBudget();
+            std::cout << "\t\t" << (long long)presupuesto.getEvaluaciones() << "\t\t"
+                    << presupuesto.getSegundos() << std::endl;
+        }
     } catch (std::exception &e) {
         std::cout << e.what() << std::endl;
     }
@@ -1,5 +1,5 @@
 /**
-* @file sec_sum.hpp
+* @file sec_op.hpp
 * @brief Secure operations functions
 *
 */
@@ -11,11 +11,13 @@
 
 /**
  * Add two signed integers preventing overflow
+ *
+ * Inline, so the header can be included from several sources
  * @param a		operand a
  * @param b		operand b
  * @return 		sum
  */
-int sec_sum(int a, int b)
+inline int sec_sum(int a, int b)
 {
 	int sum;
 	if (((b > 0) && (a > (INT_MAX - b))) ||
@@ -34,7 +36,7 @@ int sec_sum(int a, int b)
  * @param b		operand b
  * @return 		diff
  */
-int sec_diff(int a, int b)
+inline int sec_diff(int a, int b)
 {
 	signed diff;
 	if ((b > 0 && a < INT_MIN + b) ||
@@ -0,0 +1,141 @@
+/**
+ * @file Generator.cpp
+ * @brief Command line tool writing synthetic instances
+ *
+ * Usage: SQ_Generator DIR [-seed S] [-transistors N] [-domains D] [-domain-size MIN MAX]
+ *        [-degree K] [-graph random|geometric|clustered] [-clusters C] [-intra F]
+ *        [-penalty uniform|powers|constant] [-max-penalty M] [-max-bound B] [-binary]
+ */
+
+#include "../InstanceGenerator.hpp"
+#include "../InstanceCache.hpp"
+#include "../Parser.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <sys/stat.h>
+
+/**
+ * @brief Parses the instance just written and saves its binary form next to it
+ *
+ * The binary file is built for runs without limit of transistors (-limit 0).
+ *
+ * @param [in]	dir		folder of the instance
+ */
+
+static void guardarBinario(const std::string& dir)
+{
+    std::vector<std::string> fuentes = {dir + "/dom.txt", dir + "/var.txt", dir + "/ctr.txt"};
+    std::vector<Restriction> restrictions;
+    std::vector<std::vector<int>> freqs;
+    std::vector<Transistor> transistors;
+    std::vector<int> equivalenceIndex;
+    Adjacency adjacency;
+    RestrictionStore restrictionStore;
+    DomainTable domains;
+
+    Parser::FRangeParse(fuentes[0], freqs);
+    Parser::TParse(fuentes[1], &freqs, transistors, equivalenceIndex, INT_MAX);
+    Parser::RTParse(fuentes[2], restrictions, equivalenceIndex);
+    Parser::genAdjacency(transistors, restrictions, adjacency);
+    Parser::genRestrictionStore(restrictions, restrictionStore);
+    Parser::genDomainTable(freqs, transistors, domains);
+
+    if (!InstanceCache::save(dir + "/instance.cache", fuentes, INT_MAX, domains, restrictionStore,
+            adjacency))
+        throw std::runtime_error("Can not write " + dir + "/instance.cache");
+}
+
+
+/**
+ * @brief Main function of the generator
+ *
+ * @param [in]	argc	arguments of the generator
+ * @param [in]	argv	arguments of the generator
+ * @return 0, or 1 if the instance could not be written
+ */
+
+int main(int argc, char** argv)
+{
+    try {
+        if (argc < 2 || argv[1][0] == '-')
+            throw std::invalid_argument("Usage: SQ_Generator DIR [-seed S] [-transistors N] [-domains D] "
+                    "[-domain-size MIN MAX] [-degree K] [-graph random|geometric|clustered] [-clusters C] "
+                    "[-intra F] [-penalty uniform|powers|constant] [-max-penalty M] [-max-bound B] [-binary]");
+
+        std::string dir = argv[1];
+        GeneratorOptions options;
+        bool binario = false;
+        for (int i = 2; i < argc; ++i)
+        {
+            std::string opcion = argv[i];
+            bool valor = i + 1 < argc;
+            if (opcion == "-seed" && valor)
+                options.seed = std::stoull(argv[++i]);
+            else if (opcion == "-transistors" && valor)
+                options.transistors = std::stoul(argv[++i]);
+            else if (opcion == "-domains" && valor)
+                options.domains = std::stoul(argv[++i]);
+            else if (opcion == "-domain-size" && i + 2 < argc)
+            {
+                options.minDomain = std::stoul(argv[++i]);
+                options.maxDomain = std::stoul(argv[++i]);
+            }
+            else if (opcion == "-degree" && valor)
+                options.degree = std::stod(argv[++i]);
+            else if (opcion == "-graph" && valor)
+            {
+                std::string grafo = argv[++i];
+                if (grafo == "random")
+                    options.graph = 0;
+                else if (grafo == "geometric")
+                    options.graph = 1;
+                else if (grafo == "clustered")
+                    options.graph = 2;
+                else
+                    throw std::invalid_argument("The graphs are random, geometric and clustered");
+            }
+            else if (opcion == "-clusters" && valor)
+                options.clusters = std::stoul(argv[++i]);
+            else if (opcion == "-intra" && valor)
+                options.intra = std::stod(argv[++i]);
+            else if (opcion == "-penalty" && valor)
+            {
+                std::string penalizacion = argv[++i];
+                if (penalizacion == "uniform")
+                    options.penalty = 0;
+                else if (penalizacion == "powers")
+                    options.penalty = 1;
+                else if (penalizacion == "constant")
+                    options.penalty = 2;
+                else
+                    throw std::invalid_argument("The penalties are uniform, powers and constant");
+            }
+            else if (opcion == "-max-penalty" && valor)
+                options.maxPenalty = std::stoi(argv[++i]);
+            else if (opcion == "-max-bound" && valor)
+                options.maxBound = std::stoi(argv[++i]);
+            else if (opcion == "-binary")
+                binario = true;
+            else
+                throw std::invalid_argument("Unknown argument " + opcion);
+        }
+
+        mkdir(dir.c_str(), 0755);
+        auto inicio = std::chrono::steady_clock::now();
+        InstanceGenerator generador(options);
+        unsigned long long restricciones = generador.write(dir);
+        if (binario)
+            guardarBinario(dir);
+        double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+        std::printf("%u transistors, %llu restrictions (average degree %.2f) written to %s in %.2f s\n",
+                options.transistors, restricciones, 2.0 * restricciones / options.transistors,
+                dir.c_str(), segundos);
+    } catch (std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+#!/bin/sh
+################################################################################
+# Checks that a search stopped by SIGINT and resumed from the checkpoint it
+# wrote ends exactly as the same search run without stopping.
+#
+# Usage: checkResume.sh SQ_Practices SQ_Generator [SECONDS]
+#
+# SECONDS is how long each search runs before the signal (1 by default). The
+# memetic models and the tabu search are the ones whose rounds run nested
+# searches that the signal cuts short.
+################################################################################
+
+PROGRAM=$1
+GENERATOR=$2
+ESPERA=${3:-1}
+if [ -z "$PROGRAM" ] || [ -z "$GENERATOR" ]; then
+	echo "Usage: $0 SQ_Practices SQ_Generator [SECONDS]" >&2
+	exit 2
+fi
+
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+"$GENERATOR" "$DIR/instancia" -seed 3 -transistors 2000 -degree 12 > /dev/null || exit 2
+
+FALLOS=0
+comprobar()
+{
+	MODELO=$1
+	shift
+	ARGS="$DIR/instancia -lc 7 $MODELO -o -evaluations $EVALUACIONES $*"
+
+	ESPERADO=$("$PROGRAM" $ARGS) || { echo "$MODELO${*:+ $*}: the search failed"; FALLOS=$((FALLOS + 1)); return; }
+
+	rm -f "$DIR/checkpoint"
+	"$PROGRAM" $ARGS -checkpoint "$DIR/checkpoint" -checkpoint-every 100000 > /dev/null &
+	PID=$!
+	sleep "$ESPERA"
+	kill -INT $PID 2> /dev/null
+	wait $PID
+	if [ ! -f "$DIR/checkpoint" ]; then
+		echo "$MODELO${*:+ $*}: ended before the signal, use more SECONDS"
+		FALLOS=$((FALLOS + 1))
+		return
+	fi
+
+	REANUDADO=$("$PROGRAM" $ARGS -resume "$DIR/checkpoint")
+	if [ "$REANUDADO" = "$ESPERADO" ]; then
+		echo "$MODELO${*:+ $*}: ok"
+	else
+		echo "$MODELO${*:+ $*}: resumed $REANUDADO, expected $ESPERADO"
+		FALLOS=$((FALLOS + 1))
+	fi
+}
+
+EVALUACIONES=40000
+comprobar "generacional blx"
+comprobar "am1010 blx"
+comprobar "am1001 2puntos"
+comprobar "am1001Mej blx"
+comprobar "am1010 2puntos" -localsearch tabu
+EVALUACIONES=200000
+comprobar "tabu blx"
+
+[ $FALLOS -eq 0 ]